@@ -0,0 +1,468 @@
+/*
+    DecompressInputSource.cpp
+
+    Implementation file for an input source that decompresses gzip, zip, and zstd input
+*/
+
+#include "DecompressInputSource.hpp"
+#include "ReadAheadInputSource.hpp"
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // compressed input from the source, consumed by a decompressor
+    class Decompressor {
+
+        public:
+
+        Decompressor(InputSource& source, std::string_view input, std::string& error) : source(source), input(input), error(error) {}
+
+        Decompressor(const Decompressor&) = delete;
+
+        Decompressor& operator=(const Decompressor&) = delete;
+
+        virtual ~Decompressor() = default;
+
+        /*
+            Decompress into the data of a slot, called on the reader thread
+
+            @param data Start of the data
+            @param size Size of the data
+            @return Number of bytes decompressed
+            @retval 0 EOF
+            @retval -1 Error
+        */
+        [[nodiscard]] virtual long produce(char* data, std::size_t size) = 0;
+
+        protected:
+
+        // refill the compressed input, keeping any unconsumed input
+        [[nodiscard]] long refillInput() {
+
+            return source.refill(input);
+        }
+
+        // compressed input of at least the size
+        [[nodiscard]] bool ensureInput(std::size_t size) {
+
+            while (input.size() < size) {
+                if (refillInput() <= 0)
+                    return false;
+            }
+
+            return true;
+        }
+
+        // error of the compressed input, with the message for the source
+        [[nodiscard]] long inputError(std::string_view message) {
+
+            error = message;
+            return -1;
+        }
+
+        InputSource& source;
+        std::string_view input;
+
+        // message of the error, read by the parser after the refill with the error
+        std::string& error;
+    };
+
+    // error in the compressed input before decompression starts, with the message for the source
+    std::nullptr_t inputError(std::string& error, std::string_view message) {
+
+        error = message;
+        return nullptr;
+    }
+
+    // little-endian unsigned integer of the size at the start of the data
+    std::uint64_t littleEndian(const char* data, int size) {
+
+        std::uint64_t value = 0;
+        for (int i = size - 1; i >= 0; --i)
+            value = (value << 8) | static_cast<unsigned char>(data[i]);
+
+        return value;
+    }
+
+#ifdef HAVE_ZLIB
+    // deflate stream, with a gzip header, or raw as in a zip entry
+    class InflateDecompressor : public Decompressor {
+
+        public:
+
+        InflateDecompressor(InputSource& source, std::string_view input, std::string& error, bool gzip) : Decompressor(source, input, error), gzip(gzip) {
+
+            // raw deflate uses negative window bits
+            valid = inflateInit2(&stream, gzip ? 15 + 16 : -15) == Z_OK;
+        }
+
+        ~InflateDecompressor() override {
+
+            if (valid)
+                inflateEnd(&stream);
+        }
+
+        [[nodiscard]] bool isValid() const {
+
+            return valid;
+        }
+
+        [[nodiscard]] long produce(char* data, std::size_t size) override {
+
+            if (finished)
+                return 0;
+
+            stream.next_out = reinterpret_cast<Bytef*>(data);
+            stream.avail_out = static_cast<uInt>(size);
+            while (stream.avail_out > 0) {
+
+                if (input.empty()) {
+                    const long bytesRead = refillInput();
+                    if (bytesRead < 0)
+                        return -1;
+                    if (bytesRead == 0)
+                        return inputError("Truncated compressed input"sv);
+                }
+
+                // avail_in is 32 bits, so the input of a large mapped file is given in parts
+                const uInt available = static_cast<uInt>(std::min<std::size_t>(input.size(), std::numeric_limits<uInt>::max()));
+                stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+                stream.avail_in = available;
+                const int status = inflate(&stream, Z_NO_FLUSH);
+                input.remove_prefix(available - stream.avail_in);
+                if (status == Z_STREAM_END) {
+
+                    // a gzip file may have more members, e.g., from concatenated files
+                    if (gzip && ensureInput(2) && input[0] == '\x1f' && input[1] == '\x8b') {
+                        inflateReset(&stream);
+                        continue;
+                    }
+                    finished = true;
+                    break;
+                }
+                if (status != Z_OK && status != Z_BUF_ERROR)
+                    return inputError("Invalid compressed input"sv);
+            }
+
+            return static_cast<long>(size - stream.avail_out);
+        }
+
+        private:
+
+        z_stream stream{};
+        bool gzip;
+        bool valid = false;
+        bool finished = false;
+    };
+#endif
+
+    // stored zip entry, i.e., without compression
+    class StoredDecompressor : public Decompressor {
+
+        public:
+
+        StoredDecompressor(InputSource& source, std::string_view input, std::string& error, std::uint64_t remaining) : Decompressor(source, input, error), remaining(remaining) {}
+
+        [[nodiscard]] long produce(char* data, std::size_t size) override {
+
+            std::size_t produced = 0;
+            while (produced < size && remaining > 0) {
+
+                if (input.empty()) {
+                    const long bytesRead = refillInput();
+                    if (bytesRead < 0)
+                        return -1;
+                    if (bytesRead == 0)
+                        return inputError("Truncated zip input"sv);
+                }
+
+                const std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>({ size - produced, remaining, input.size() }));
+                std::copy(input.data(), input.data() + count, data + produced);
+                input.remove_prefix(count);
+                produced += count;
+                remaining -= count;
+            }
+
+            return static_cast<long>(produced);
+        }
+
+        private:
+
+        std::uint64_t remaining;
+    };
+
+#ifdef HAVE_ZSTD
+    // zstd frames, decompressed in order
+    class ZstdDecompressor : public Decompressor {
+
+        public:
+
+        ZstdDecompressor(InputSource& source, std::string_view input, std::string& error) : Decompressor(source, input, error), stream(ZSTD_createDStream()) {
+
+            if (stream)
+                ZSTD_initDStream(stream);
+        }
+
+        ~ZstdDecompressor() override {
+
+            ZSTD_freeDStream(stream);
+        }
+
+        [[nodiscard]] bool isValid() const {
+
+            return stream != nullptr;
+        }
+
+        [[nodiscard]] long produce(char* data, std::size_t size) override {
+
+            ZSTD_outBuffer out = { data, size, 0 };
+            while (out.pos < out.size) {
+
+                if (input.empty()) {
+                    const long bytesRead = refillInput();
+                    if (bytesRead < 0)
+                        return -1;
+
+                    // EOF is only valid at the end of a frame
+                    if (bytesRead == 0) {
+                        if (frameRemaining != 0)
+                            return inputError("Truncated compressed input"sv);
+                        break;
+                    }
+                }
+
+                ZSTD_inBuffer in = { input.data(), input.size(), 0 };
+                frameRemaining = ZSTD_decompressStream(stream, &out, &in);
+                input.remove_prefix(in.pos);
+                if (ZSTD_isError(frameRemaining))
+                    return inputError("Invalid compressed input"sv);
+            }
+
+            return static_cast<long>(out.pos);
+        }
+
+        private:
+
+        ZSTD_DStream* stream;
+        std::size_t frameRemaining = 0;
+    };
+#endif
+
+    /*
+        Decompressor for the first entry of a zip archive
+
+        @param source Input source of the archive
+        @param input Input from the source, at the start of the archive
+        @param[out] error Message of an error in the input, for the source and set by the decompressor
+        @return Decompressor
+        @retval nullptr Error, with the message
+    */
+    std::shared_ptr<Decompressor> makeZipDecompressor(InputSource& source, std::string_view input, std::string& error) {
+
+        // local file header
+        const std::size_t HEADER_SIZE = 30;
+        while (input.size() < HEADER_SIZE) {
+            if (source.refill(input) <= 0)
+                return inputError(error, "Truncated zip input"sv);
+        }
+        const auto flags = littleEndian(input.data() + 6, 2);
+        const auto method = littleEndian(input.data() + 8, 2);
+        std::uint64_t compressedSize = littleEndian(input.data() + 18, 4);
+        const auto nameLength = littleEndian(input.data() + 26, 2);
+        const auto extraLength = littleEndian(input.data() + 28, 2);
+        while (input.size() < HEADER_SIZE + nameLength + extraLength) {
+            if (source.refill(input) <= 0)
+                return inputError(error, "Truncated zip input"sv);
+        }
+
+        // zip64 sizes are in an extra field
+        std::string_view extra = input.substr(HEADER_SIZE + nameLength, extraLength);
+        while (compressedSize == 0xFFFFFFFF && extra.size() >= 4) {
+            const auto id = littleEndian(extra.data(), 2);
+            const auto size = littleEndian(extra.data() + 2, 2);
+            if (id == 0x0001 && size >= 16 && extra.size() >= 20)
+                compressedSize = littleEndian(extra.data() + 12, 8);
+            extra.remove_prefix(std::min<std::size_t>(extra.size(), 4 + size));
+        }
+        input.remove_prefix(HEADER_SIZE + nameLength + extraLength);
+
+        // stored entry
+        if (method == 0) {
+
+            // without compression, the end of the data is only known from its size
+            if (flags & 0x08) {
+                return inputError(error, "Stored zip entry without a size"sv);
+            }
+
+            return std::make_shared<StoredDecompressor>(source, input, error, compressedSize);
+        }
+
+        // deflated entry
+        if (method == 8) {
+#ifdef HAVE_ZLIB
+            auto decompressor = std::make_shared<InflateDecompressor>(source, input, error, false);
+            if (decompressor->isValid())
+                return decompressor;
+            return inputError(error, "Unable to start decompression"sv);
+#else
+            return inputError(error, "zip input requires a build with zlib"sv);
+#endif
+            return nullptr;
+        }
+
+        return inputError(error, "Unsupported zip compression method"sv);
+    }
+
+    /*
+        Decompressor for the input
+
+        @param compression Compression of the input
+        @param source Input source of the compressed input
+        @param input Input from the source, at the start of the compressed input
+        @param[out] error Message of an error in the input, for the source and set by the decompressor
+        @return Decompressor
+        @retval nullptr Error, with the message
+    */
+    std::shared_ptr<Decompressor> makeDecompressor(Compression compression, InputSource& source, std::string_view input, std::string& error) {
+
+        if (compression == Compression::ZIP)
+            return makeZipDecompressor(source, input, error);
+
+        if (compression == Compression::GZIP) {
+#ifdef HAVE_ZLIB
+            auto decompressor = std::make_shared<InflateDecompressor>(source, input, error, true);
+            if (decompressor->isValid())
+                return decompressor;
+            return inputError(error, "Unable to start decompression"sv);
+#else
+            return inputError(error, "gzip input requires a build with zlib"sv);
+#endif
+            return nullptr;
+        }
+
+#ifdef HAVE_ZSTD
+        auto decompressor = std::make_shared<ZstdDecompressor>(source, input, error);
+        if (decompressor->isValid())
+            return decompressor;
+        return inputError(error, "Unable to start decompression"sv);
+#else
+        return inputError(error, "zstd input requires a build with zstd"sv);
+#endif
+        return nullptr;
+    }
+
+    // name of the compression
+    std::string_view compressionName(Compression compression) {
+
+        switch (compression) {
+        case Compression::GZIP: return "gzip"sv;
+        case Compression::ZIP:  return "zip"sv;
+        case Compression::ZSTD: return "zstd"sv;
+        default:                return ""sv;
+        }
+    }
+}
+
+/*
+    Compression of the input from its magic bytes
+
+    @param start Start of the input, at least 4 bytes when available
+    @return Compression of the input
+*/
+[[nodiscard]] Compression detectCompression(std::string_view start) {
+
+    if (start.substr(0, 2) == "\x1f\x8b"sv)
+        return Compression::GZIP;
+    if (start.substr(0, 4) == "PK\x03\x04"sv)
+        return Compression::ZIP;
+    if (start.substr(0, 4) == "\x28\xb5\x2f\xfd"sv)
+        return Compression::ZSTD;
+
+    return Compression::NONE;
+}
+
+// constructor
+DecompressInputSource::DecompressInputSource(std::unique_ptr<InputSource> source, std::size_t bufferSize)
+    : source(std::move(source)), bufferSize(bufferSize) {}
+
+// destructor, stopping the reader thread
+DecompressInputSource::~DecompressInputSource() = default;
+
+// detect the compression, and start the decompression
+[[nodiscard]] long DecompressInputSource::start(std::string_view& content) {
+
+    detected = true;
+
+    // enough input for the magic bytes
+    std::string_view input;
+    long bytesRead = 0;
+    while (input.size() < 4 && (bytesRead = source->refill(input)) > 0) {
+    }
+    if (bytesRead < 0)
+        return -1;
+
+    // uncompressed input is passed through from the source
+    compression = detectCompression(input);
+    if (compression == Compression::NONE) {
+        content = input;
+        return static_cast<long>(input.size());
+    }
+
+    auto decompressor = makeDecompressor(compression, *source, input, errorMessage);
+    if (!decompressor)
+        return -1;
+
+    modeName = std::string(source->mode()) + ", " + std::string(compressionName(compression));
+    decompressed = std::make_unique<ReadAheadInputSource>([decompressor](char* data, std::size_t size) {
+        return decompressor->produce(data, size);
+    }, modeName, bufferSize);
+
+    return decompressed->refill(content);
+}
+
+/*
+    Refill the content preserving the existing data.
+
+    @param[in, out] content View of the content
+    @return Number of bytes read, or decompressed
+    @retval 0 EOF
+    @retval -1 Read error, or invalid compressed input
+*/
+[[nodiscard]] long DecompressInputSource::refill(std::string_view& content) {
+
+    if (!detected)
+        return start(content);
+
+    if (decompressed)
+        return decompressed->refill(content);
+
+    return source->refill(content);
+}
+
+// message of the error in the compressed input, empty if none
+[[nodiscard]] std::string_view DecompressInputSource::error() const {
+
+    return errorMessage;
+}
+
+// name of the input mode, with the compression
+[[nodiscard]] std::string_view DecompressInputSource::mode() const {
+
+    if (decompressed)
+        return modeName;
+
+    return source->mode();
+}
@@ -0,0 +1,77 @@
+/*
+    DecompressInputSource.hpp
+
+    Include file for an input source that decompresses gzip, zip, and zstd input.
+
+    The compression is detected from the magic bytes at the start of the input,
+    so compressed and uncompressed srcML are read the same way. Compressed input
+    is decompressed on a reader thread into the slots of a read-ahead ring,
+    so decompression overlaps parsing, and the decompressed document is never
+    stored in full. Uncompressed input is passed through from the source.
+
+    For zip, the first entry of the archive is decompressed.
+    zstd input requires a build with zstd.
+*/
+
+#ifndef INCLUDED_DECOMPRESSINPUTSOURCE_HPP
+#define INCLUDED_DECOMPRESSINPUTSOURCE_HPP
+
+#include "InputSource.hpp"
+#include <string>
+
+class ReadAheadInputSource;
+
+// compression of the input
+enum class Compression { NONE, GZIP, ZIP, ZSTD };
+
+/*
+    Compression of the input from its magic bytes
+
+    @param start Start of the input, at least 4 bytes when available
+    @return Compression of the input
+*/
+[[nodiscard]] Compression detectCompression(std::string_view start);
+
+class DecompressInputSource : public InputSource {
+
+    private:
+
+    std::unique_ptr<InputSource> source;
+    std::size_t bufferSize;
+    Compression compression = Compression::NONE;
+    bool detected = false;
+    std::string modeName;
+
+    // message of an error in the compressed input, set on the reader thread before the refill with the error
+    std::string errorMessage;
+
+    // declared after the source, so the reader thread stops before the source is destroyed
+    std::unique_ptr<ReadAheadInputSource> decompressed;
+
+    // detect the compression, and start the decompression
+    [[nodiscard]] long start(std::string_view& content);
+
+    public:
+
+    /*
+        Constructor
+
+        @param source Input source of the possibly compressed input
+        @param bufferSize Size of the decompressed data of each refill
+    */
+    explicit DecompressInputSource(std::unique_ptr<InputSource> source, std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+    DecompressInputSource(const DecompressInputSource&) = delete;
+
+    DecompressInputSource& operator=(const DecompressInputSource&) = delete;
+
+    ~DecompressInputSource() override;
+
+    [[nodiscard]] long refill(std::string_view& content) override;
+
+    [[nodiscard]] std::string_view mode() const override;
+
+    [[nodiscard]] std::string_view error() const override;
+};
+
+#endif
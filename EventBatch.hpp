@@ -0,0 +1,60 @@
+/*
+    EventBatch.hpp
+
+    Include file for a batch of parser events in a struct-of-arrays layout.
+
+    A handler that subscribes to BATCH receives the start tags, end tags,
+    attributes, comments, CDATA, and characters it subscribes to in batches,
+    instead of a handler call for each event. Each event has a kind, a name ID,
+    and the offset and length of its text, relative to the base of the batch:
+    * START_TAG and END_TAG, the qualified name
+    * ATTRIBUTE, the value
+    * COMMENT, the comment
+    * CDATA, the characters
+    * CHARACTER_ENTITY_REFERENCES, the reference in the source, e.g., "&lt;"
+    * CHARACTER_NON_ENTITY_REFERENCES, the characters
+    The name ID is only for tags and attributes.
+
+    The text of the events is in the content of the parser, so a batch is
+    valid only during the handler call.
+*/
+
+#ifndef INCLUDED_EVENTBATCH_HPP
+#define INCLUDED_EVENTBATCH_HPP
+
+#include <string_view>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+struct EventBatch {
+
+    // maximum number of events in a batch
+    static constexpr std::size_t CAPACITY = 4096;
+
+    // number of events in the batch
+    std::size_t size = 0;
+
+    // start of the text of the first event, with offsets relative to it
+    const char* base = nullptr;
+
+    // XMLParserHandler::Event of each event
+    std::array<std::uint16_t, CAPACITY> kinds;
+
+    // NameTable ID of the name of each tag and attribute
+    std::array<std::int32_t, CAPACITY> nameIDs;
+
+    // offset of the text of each event from the base
+    std::array<std::uint32_t, CAPACITY> offsets;
+
+    // length of the text of each event
+    std::array<std::uint32_t, CAPACITY> lengths;
+
+    // text of the event
+    [[nodiscard]] std::string_view text(std::size_t event) const {
+
+        return std::string_view(base + offsets[event], lengths[event]);
+    }
+};
+
+#endif
@@ -0,0 +1,136 @@
+/*
+    InputSource.cpp
+
+    Implementation file for the input source factory functions
+*/
+
+#include "InputSource.hpp"
+#include "ReadInputSource.hpp"
+#include "ReadAheadInputSource.hpp"
+#include "MMapInputSource.hpp"
+#include "UringInputSource.hpp"
+#include "DecompressInputSource.hpp"
+
+#if !defined(_MSC_VER)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#define OPEN open
+#define CLOSE close
+#else
+#include <io.h>
+#include <fcntl.h>
+#define OPEN _open
+#define CLOSE _close
+#endif
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // file descriptor is for a regular file
+    bool isRegularFile(int fd) {
+
+#if !defined(_MSC_VER)
+        struct stat st;
+        return fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+#else
+        return false;
+#endif
+    }
+
+    // input source for the mode, with a memory-mapped input source already tried for AUTO and MMAP
+    std::unique_ptr<InputSource> makeReadSource(int fd, std::size_t bufferSize, InputMode mode, bool ownsFD) {
+
+        if (mode == InputMode::IO_URING && isRegularFile(fd)) {
+            auto ring = IOUring::shared(bufferSize);
+            if (ring)
+                return std::make_unique<UringInputSource>(std::move(ring), fd, ownsFD);
+        }
+
+        if (mode == InputMode::AUTO || mode == InputMode::READ_AHEAD)
+            return std::make_unique<ReadAheadInputSource>(fd, bufferSize, 4, ownsFD);
+
+        return std::make_unique<ReadInputSource>(fd, bufferSize, ownsFD);
+    }
+
+    // input source for the file descriptor and mode, before any decompression
+    std::unique_ptr<InputSource> makeFileSource(int fd, std::size_t bufferSize, InputMode mode, bool ownsFD) {
+
+        // mapping remains valid after the file is closed
+        if (mode == InputMode::AUTO || mode == InputMode::MMAP) {
+            auto mapped = std::make_unique<MMapInputSource>(fd);
+            if (mapped->isMapped()) {
+                if (ownsFD)
+                    CLOSE(fd);
+                return mapped;
+            }
+        }
+
+        return makeReadSource(fd, bufferSize, mode, ownsFD);
+    }
+}
+
+/*
+    Input mode from its name, i.e., "auto", "mmap", "read", "read-ahead", or "io_uring"
+
+    @param name Name of the input mode
+    @param[out] mode Input mode
+    @return If the name is an input mode
+*/
+[[nodiscard]] bool parseInputMode(std::string_view name, InputMode& mode) {
+
+    if (name == "auto"sv)
+        mode = InputMode::AUTO;
+    else if (name == "mmap"sv)
+        mode = InputMode::MMAP;
+    else if (name == "read"sv)
+        mode = InputMode::READ;
+    else if (name == "read-ahead"sv)
+        mode = InputMode::READ_AHEAD;
+    else if (name == "io_uring"sv)
+        mode = InputMode::IO_URING;
+    else
+        return false;
+
+    return true;
+}
+
+/*
+    Create an input source for an open file descriptor.
+    By default, a regular file is memory mapped, otherwise, e.g., for a pipe,
+    the input is read ahead of the parser by a reader thread.
+    An input mode that does not apply to the file, e.g., mmap or io_uring
+    for a pipe, or io_uring when it is not available, falls back to read.
+    Compressed input, i.e., gzip, zip, or zstd, is decompressed.
+
+    @param fd File descriptor of the input
+    @param bufferSize Size of the buffer when the input is read
+    @param mode Input mode
+    @return Input source
+*/
+[[nodiscard]] std::unique_ptr<InputSource> makeInputSource(int fd, std::size_t bufferSize, InputMode mode) {
+
+    return std::make_unique<DecompressInputSource>(makeFileSource(fd, bufferSize, mode, false), bufferSize);
+}
+
+/*
+    Create an input source for a named file.
+    By default, a regular file is memory mapped, otherwise the input is read ahead of the parser by a reader thread.
+    Compressed input, i.e., gzip, zip, or zstd, is decompressed.
+
+    @param filename Path of the input file
+    @param bufferSize Size of the buffer when the input is read
+    @param mode Input mode
+    @return Input source
+    @retval nullptr File cannot be opened
+*/
+[[nodiscard]] std::unique_ptr<InputSource> makeInputSource(const char* filename, std::size_t bufferSize, InputMode mode) {
+
+    const int fd = OPEN(filename, O_RDONLY);
+    if (fd == -1)
+        return nullptr;
+
+    return std::make_unique<DecompressInputSource>(makeFileSource(fd, bufferSize, mode, true), bufferSize);
+}
@@ -0,0 +1,79 @@
+/*
+    InputSource.hpp
+
+    Include file for the input source interface of the XML parser
+*/
+
+#ifndef INCLUDED_INPUTSOURCE_HPP
+#define INCLUDED_INPUTSOURCE_HPP
+
+#include <string_view>
+#include <memory>
+#include <cstddef>
+
+// default size of the buffer for buffered input sources
+const std::size_t DEFAULT_BUFFER_SIZE = 16 * 16 * 4096;
+
+// how input is read, with AUTO choosing by the type of file
+enum class InputMode { AUTO, MMAP, READ, READ_AHEAD, IO_URING };
+
+/*
+    Input mode from its name, i.e., "auto", "mmap", "read", "read-ahead", or "io_uring"
+
+    @param name Name of the input mode
+    @param[out] mode Input mode
+    @return If the name is an input mode
+*/
+[[nodiscard]] bool parseInputMode(std::string_view name, InputMode& mode);
+
+class InputSource {
+    public:
+
+    virtual ~InputSource() = default;
+
+    /*
+        Refill the content preserving the existing data.
+
+        @param[in, out] content View of the content
+        @return Number of bytes read
+        @retval 0 EOF
+        @retval -1 Read error
+    */
+    [[nodiscard]] virtual long refill(std::string_view& content) = 0;
+
+    // Name of the input mode, e.g., "read" or "mmap"
+    [[nodiscard]] virtual std::string_view mode() const = 0;
+
+    // Message of the error of a refill that returned -1, empty if there is no message, e.g., for a read error
+    [[nodiscard]] virtual std::string_view error() const { return std::string_view(); }
+};
+
+/*
+    Create an input source for an open file descriptor.
+    By default, a regular file is memory mapped, otherwise, e.g., for a pipe,
+    the input is read ahead of the parser by a reader thread.
+    An input mode that does not apply to the file, e.g., mmap or io_uring
+    for a pipe, or io_uring when it is not available, falls back to read.
+    Compressed input, i.e., gzip, zip, or zstd, is decompressed.
+
+    @param fd File descriptor of the input
+    @param bufferSize Size of the buffer when the input is read
+    @param mode Input mode
+    @return Input source
+*/
+[[nodiscard]] std::unique_ptr<InputSource> makeInputSource(int fd = 0, std::size_t bufferSize = DEFAULT_BUFFER_SIZE, InputMode mode = InputMode::AUTO);
+
+/*
+    Create an input source for a named file.
+    By default, a regular file is memory mapped, otherwise the input is read ahead of the parser by a reader thread.
+    Compressed input, i.e., gzip, zip, or zstd, is decompressed.
+
+    @param filename Path of the input file
+    @param bufferSize Size of the buffer when the input is read
+    @param mode Input mode
+    @return Input source
+    @retval nullptr File cannot be opened
+*/
+[[nodiscard]] std::unique_ptr<InputSource> makeInputSource(const char* filename, std::size_t bufferSize = DEFAULT_BUFFER_SIZE, InputMode mode = InputMode::AUTO);
+
+#endif
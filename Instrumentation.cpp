@@ -0,0 +1,125 @@
+/*
+    Instrumentation.cpp
+
+    Implementation file for the instrumentation of the parser
+*/
+
+#include "Instrumentation.hpp"
+
+#include <iomanip>
+#include <mutex>
+#include <string>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // names of the event kinds, in the order of the bits of XMLParserHandler::Event
+    constexpr std::string_view KIND_NAMES[Instrumentation::KIND_COUNT] = {
+        "Start Document"sv, "XML Declaration"sv, "DOCTYPE"sv, "Start Tag"sv, "End Tag"sv,
+        "Attribute"sv, "XML Namespace"sv, "XML Comment"sv, "CDATA"sv, "Processing Instruction"sv,
+        "CER"sv, "nonCER"sv, "End Document"sv, "Raw"sv, "Batch"sv, "Skipped"sv, "Other"sv
+    };
+
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    constexpr std::string_view TICKS = "cycles"sv;
+#else
+    constexpr std::string_view TICKS = "ns"sv;
+#endif
+
+    // total of the fragment parses of all threads
+    std::mutex fragmentMutex;
+    Instrumentation fragmentTotal;
+    std::uint64_t fragmentCount = 0;
+}
+
+// add the counts and ticks of another parse
+void Instrumentation::merge(const Instrumentation& other) {
+
+    parseTicks += other.parseTicks;
+    if (!timerTicks || other.timerTicks < timerTicks)
+        timerTicks = other.timerTicks;
+    for (int kind = 0; kind < KIND_COUNT; ++kind) {
+        tokenCounts[kind] += other.tokenCounts[kind];
+        tokenBytes[kind] += other.tokenBytes[kind];
+        handlerCounts[kind] += other.handlerCounts[kind];
+        sampledHandlers[kind] += other.sampledHandlers[kind];
+        handlerTicks[kind] += other.handlerTicks[kind];
+    }
+    handlerCalls += other.handlerCalls;
+    refills += other.refills;
+    refillBytes += other.refillBytes;
+    refillTicks += other.refillTicks;
+}
+
+// add the counts and ticks of a fragment parse to the total of all fragments, from any thread
+void Instrumentation::addFragment(const Instrumentation& fragment) {
+
+    const std::lock_guard<std::mutex> lock(fragmentMutex);
+    fragmentTotal.merge(fragment);
+    ++fragmentCount;
+}
+
+/*
+    Report the total of the fragment parses, if any, and clear it
+
+    @param out Stream for the report, e.g., std::clog
+*/
+void Instrumentation::reportFragments(std::ostream& out) {
+
+    const std::lock_guard<std::mutex> lock(fragmentMutex);
+    if (!fragmentCount)
+        return;
+
+    // parse ticks are the sum over the threads, not the elapsed ticks
+    fragmentTotal.report(out, "Instrumentation of " + std::to_string(fragmentCount) + " fragments");
+    fragmentTotal = Instrumentation();
+    fragmentCount = 0;
+}
+
+/*
+    Report the counts and ticks as a markdown table
+
+    @param out Stream for the report, e.g., std::clog
+    @param title Title of the report
+*/
+void Instrumentation::report(std::ostream& out, std::string_view title) const {
+
+    const Ticks totalTicks = parseTicks;
+    Ticks allHandlerTicks = 0;
+
+    out << "\n# " << title << " (" << TICKS << ")\n";
+    out << "| Event                  |       Tokens |          Bytes |        Calls |  Ticks/Call |     Ticks (est.) |\n";
+    out << "|:-----------------------|-------------:|---------------:|-------------:|------------:|-----------------:|\n";
+    for (int kind = 0; kind < KIND_COUNT; ++kind) {
+        if (!tokenCounts[kind] && !handlerCounts[kind])
+            continue;
+
+        // ticks of all calls are estimated from the sampled calls
+        const double ticksPerCall = sampledHandlers[kind] ? static_cast<double>(handlerTicks[kind]) / sampledHandlers[kind] : 0;
+        const Ticks estimatedTicks = static_cast<Ticks>(ticksPerCall * handlerCounts[kind]);
+        allHandlerTicks += estimatedTicks;
+        out << "| " << std::setw(22) << std::left << KIND_NAMES[kind] << std::right
+            << " | " << std::setw(12) << tokenCounts[kind]
+            << " | " << std::setw(14) << tokenBytes[kind]
+            << " | " << std::setw(12) << handlerCounts[kind]
+            << " | " << std::setw(11) << std::fixed << std::setprecision(1) << ticksPerCall
+            << " | " << std::setw(16) << estimatedTicks << " |\n";
+    }
+
+    // share of the whole parse
+    const auto percent = [totalTicks](Ticks ticks) { return totalTicks ? 100.0 * static_cast<double>(ticks) / static_cast<double>(totalTicks) : 0.0; };
+    out << '\n';
+    out << "| Measure                |            Value |\n";
+    out << "|:-----------------------|-----------------:|\n";
+    out << "| Parse ticks            | " << std::setw(16) << totalTicks << " |\n";
+    out << "| Timer ticks            | " << std::setw(16) << timerTicks << " |\n";
+    out << "| Refills                | " << std::setw(16) << refills << " |\n";
+    out << "| Refill bytes           | " << std::setw(16) << refillBytes << " |\n";
+    out << "| Refill ticks           | " << std::setw(16) << refillTicks << " |\n";
+    out << "| Refill stall %         | " << std::setw(16) << std::setprecision(2) << percent(refillTicks) << " |\n";
+    out << "| Handler ticks (est.)   | " << std::setw(16) << allHandlerTicks << " |\n";
+    out << "| Handler %              | " << std::setw(16) << std::setprecision(2) << percent(allHandlerTicks) << " |\n";
+    out << std::defaultfloat;
+}
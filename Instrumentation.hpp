@@ -0,0 +1,181 @@
+/*
+    Instrumentation.hpp
+
+    Include file for the instrumentation of the parser.
+
+    Counts the tokens of each event kind and their bytes, the handler calls of each
+    event kind, and the ticks of input refills and handler calls. The ticks are
+    from the time-stamp counter with rdtsc where available, otherwise nanoseconds
+    of the steady clock.
+
+    Reading the ticks costs more than most handler calls, so only one of every
+    HANDLER_SAMPLE handler calls is timed, and the ticks of all the calls are
+    estimated from the sample, without the ticks of reading the ticks.
+    Every refill is timed.
+
+    The parses of fragments, e.g., the units of an archive parsed by worker threads,
+    are added to one total for all the fragments, reported after the parallel parse.
+
+    Only used when compiled with INSTRUMENT, e.g., cmake -DINSTRUMENT=ON,
+    otherwise the parser has no instrumentation.
+*/
+
+#ifndef INCLUDED_INSTRUMENTATION_HPP
+#define INCLUDED_INSTRUMENTATION_HPP
+
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <chrono>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+class Instrumentation {
+
+    public:
+
+    using Ticks = std::uint64_t;
+
+    // number of event kinds, i.e., bits of XMLParserHandler::Event
+    static constexpr int KIND_COUNT = 17;
+
+    // one of this many handler calls is timed, a power of 2
+    static constexpr unsigned int HANDLER_SAMPLE = 64;
+
+    // current ticks
+    [[nodiscard]] static Ticks now() {
+
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<Ticks>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // start of the parse, with the ticks of reading the ticks
+    void start() {
+
+        timerTicks = ~Ticks(0);
+        for (int i = 0; i < 16; ++i) {
+            const Ticks before = now();
+            timerTicks = std::min(timerTicks, now() - before);
+        }
+        startTicks = now();
+    }
+
+    // end of the parse, with the end of the current token
+    void end(const char* position) {
+
+        endToken(position);
+        parseTicks += now() - startTicks;
+    }
+
+    // start of a token of the events at the position, which ends the previous token
+    void token(unsigned int tokenEvents, const char* position) {
+
+        endToken(position);
+        tokenKind = kindIndex(tokenEvents);
+        ++tokenCounts[tokenKind];
+        tokenStart = position;
+    }
+
+    // end of the current token at the position, e.g., before a refill moves the content
+    void endToken(const char* position) {
+
+        if (tokenStart) {
+            tokenBytes[tokenKind] += static_cast<std::uint64_t>(position - tokenStart);
+            tokenStart = nullptr;
+        }
+    }
+
+    // start of a handler call, with the ticks for a sampled call, otherwise 0
+    [[nodiscard]] Ticks startHandler() {
+
+        return (++handlerCalls & (HANDLER_SAMPLE - 1)) ? 0 : now();
+    }
+
+    // end of a handler call for the event
+    void endHandler(unsigned int event, Ticks handlerStart) {
+
+        const int kind = kindIndex(event);
+        ++handlerCounts[kind];
+        if (handlerStart) {
+            const Ticks ticks = now() - handlerStart;
+            handlerTicks[kind] += ticks > timerTicks ? ticks - timerTicks : 0;
+            ++sampledHandlers[kind];
+        }
+    }
+
+    // end of a refill of the bytes
+    void refill(Ticks refillStart, long bytesRead) {
+
+        refillTicks += now() - refillStart;
+        ++refills;
+        if (bytesRead > 0)
+            refillBytes += static_cast<std::uint64_t>(bytesRead);
+    }
+
+    // add the counts and ticks of another parse
+    void merge(const Instrumentation& other);
+
+    /*
+        Report the counts and ticks as a markdown table
+
+        @param out Stream for the report, e.g., std::clog
+        @param title Title of the report
+    */
+    void report(std::ostream& out, std::string_view title = "Instrumentation") const;
+
+    // add the counts and ticks of a fragment parse to the total of all fragments, from any thread
+    static void addFragment(const Instrumentation& fragment);
+
+    /*
+        Report the total of the fragment parses, if any, and clear it
+
+        @param out Stream for the report, e.g., std::clog
+    */
+    static void reportFragments(std::ostream& out);
+
+    private:
+
+    // index of the lowest event of the events
+    static constexpr int kindIndex(unsigned int events) {
+
+        int kind = 0;
+        while (kind < KIND_COUNT - 1 && !(events & (1U << kind)))
+            ++kind;
+        return kind;
+    }
+
+    Ticks startTicks = 0;
+
+    // ticks of the parse, or of all the parses of a total
+    Ticks parseTicks = 0;
+
+    // ticks of reading the ticks, subtracted from the timed handler calls
+    Ticks timerTicks = 0;
+
+    // current token
+    const char* tokenStart = nullptr;
+    int tokenKind = 0;
+
+    std::array<std::uint64_t, KIND_COUNT> tokenCounts{};
+    std::array<std::uint64_t, KIND_COUNT> tokenBytes{};
+
+    std::uint64_t handlerCalls = 0;
+    std::array<std::uint64_t, KIND_COUNT> handlerCounts{};
+    std::array<std::uint64_t, KIND_COUNT> sampledHandlers{};
+    std::array<Ticks, KIND_COUNT> handlerTicks{};
+
+    std::uint64_t refills = 0;
+    std::uint64_t refillBytes = 0;
+    Ticks refillTicks = 0;
+};
+
+#endif
@@ -0,0 +1,104 @@
+/*
+    MMapInputSource.cpp
+
+    Implementation file for an input source that memory maps a regular file
+*/
+
+#include "MMapInputSource.hpp"
+
+#if !defined(_MSC_VER)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+/*
+    Memory map the file when it is a non-empty regular file.
+
+    The mapping is followed by at least one page of zeros so that
+    lookahead at the end of the content never reads an unmapped page.
+
+    @param fd File descriptor of the input
+*/
+MMapInputSource::MMapInputSource(int fd) {
+
+#if !defined(_MSC_VER)
+    struct stat st;
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size == 0)
+        return;
+
+    // respect any input already consumed from the file
+    const off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (offset == -1 || offset >= st.st_size)
+        return;
+
+    const std::size_t pageSize = sysconf(_SC_PAGESIZE);
+    const std::size_t fileSize = st.st_size;
+    const std::size_t mapSize = (fileSize / pageSize + 1) * pageSize;
+
+    // reserve the zero-filled region, then map the file over the start of it
+    void* reserved = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED)
+        return;
+    if (mmap(reserved, fileSize, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(reserved, mapSize);
+        return;
+    }
+    madvise(reserved, fileSize, MADV_SEQUENTIAL);
+
+    region = static_cast<char*>(reserved);
+    regionSize = mapSize;
+    data = std::string_view(region + offset, fileSize - offset);
+#endif
+}
+
+// destructor
+MMapInputSource::~MMapInputSource() {
+
+#if !defined(_MSC_VER)
+    if (region)
+        munmap(region, regionSize);
+#endif
+}
+
+// check if the file is mapped
+[[nodiscard]] bool MMapInputSource::isMapped() const {
+
+    return region != nullptr;
+}
+
+// view of the entire mapped file
+[[nodiscard]] std::string_view MMapInputSource::view() const {
+
+    return data;
+}
+
+/*
+    Refill the content preserving the existing data.
+
+    The first call sets the content to the entire file. Later calls
+    leave the content as is and return EOF.
+
+    @param[in, out] content View of the content
+    @return Number of bytes read
+    @retval 0 EOF
+*/
+[[nodiscard]] long MMapInputSource::refill(std::string_view& content) {
+
+    if (done)
+        return 0;
+    done = true;
+
+    content = data;
+
+    return static_cast<long>(data.size());
+}
+
+// name of the input mode
+[[nodiscard]] std::string_view MMapInputSource::mode() const {
+
+    return "mmap"sv;
+}
@@ -0,0 +1,43 @@
+/*
+    MMapInputSource.hpp
+
+    Include file for an input source that memory maps a regular file
+*/
+
+#ifndef INCLUDED_MMAPINPUTSOURCE_HPP
+#define INCLUDED_MMAPINPUTSOURCE_HPP
+
+#include "InputSource.hpp"
+
+class MMapInputSource : public InputSource {
+
+    private:
+
+    char* region = nullptr;
+    std::size_t regionSize = 0;
+    std::string_view data;
+    bool done = false;
+
+    public:
+
+    // constructor, maps the file from the current offset of fd
+    explicit MMapInputSource(int fd);
+
+    MMapInputSource(const MMapInputSource&) = delete;
+
+    MMapInputSource& operator=(const MMapInputSource&) = delete;
+
+    ~MMapInputSource() override;
+
+    // check if the file is mapped, e.g., fd is not a pipe
+    [[nodiscard]] bool isMapped() const;
+
+    // view of the entire mapped file
+    [[nodiscard]] std::string_view view() const;
+
+    [[nodiscard]] long refill(std::string_view& content) override;
+
+    [[nodiscard]] std::string_view mode() const override;
+};
+
+#endif
@@ -0,0 +1,42 @@
+/*
+    MemoryInputSource.cpp
+
+    Implementation file for an input source of data already in memory
+*/
+
+#include "MemoryInputSource.hpp"
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+// constructor
+MemoryInputSource::MemoryInputSource(std::string_view data)
+    : data(data) {
+}
+
+/*
+    Refill the content preserving the existing data.
+
+    The first call sets the content to the entire data. Later calls
+    leave the content as is and return EOF.
+
+    @param[in, out] content View of the content
+    @return Number of bytes read
+    @retval 0 EOF
+*/
+[[nodiscard]] long MemoryInputSource::refill(std::string_view& content) {
+
+    if (done)
+        return 0;
+    done = true;
+
+    content = data;
+
+    return static_cast<long>(data.size());
+}
+
+// name of the input mode
+[[nodiscard]] std::string_view MemoryInputSource::mode() const {
+
+    return "memory"sv;
+}
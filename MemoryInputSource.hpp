@@ -0,0 +1,36 @@
+/*
+    MemoryInputSource.hpp
+
+    Include file for an input source of data already in memory
+*/
+
+#ifndef INCLUDED_MEMORYINPUTSOURCE_HPP
+#define INCLUDED_MEMORYINPUTSOURCE_HPP
+
+#include "InputSource.hpp"
+
+class MemoryInputSource : public InputSource {
+
+    private:
+
+    std::string_view data;
+    bool done = false;
+
+    public:
+
+    /*
+        Constructor
+
+        The parser looks ahead a few characters, so the data
+        must be followed by a null character, e.g., from std::string.
+
+        @param data View of the entire input
+    */
+    explicit MemoryInputSource(std::string_view data);
+
+    [[nodiscard]] long refill(std::string_view& content) override;
+
+    [[nodiscard]] std::string_view mode() const override;
+};
+
+#endif
@@ -0,0 +1,115 @@
+/*
+    NameTable.cpp
+
+    Implementation file for the table of interned element and attribute names.
+*/
+
+#include "NameTable.hpp"
+
+#include <algorithm>
+#include <array>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // srcML namespaces with the usual prefix of each
+    constexpr std::array<std::pair<std::string_view, std::string_view>, 3> SRCML_NAMESPACES = {{
+        { "http://www.srcML.org/srcML/src"sv, ""sv },
+        { "http://www.srcML.org/srcML/cpp"sv, "cpp"sv },
+        { "http://www.srcML.org/srcML/position"sv, "pos"sv },
+    }};
+}
+
+// table with the srcML names
+NameTable::NameTable()
+    : names(SRCML.cbegin(), SRCML.cend()), slots(1024, EMPTY_SLOT), mask(slots.size() - 1) {
+
+    for (int id = 0; id < SRCML_NAME_COUNT; ++id) {
+        std::size_t slot = hashName(names[id].prefix, names[id].localName) & mask;
+        while (slots[slot] != EMPTY_SLOT)
+            slot = (slot + 1) & mask;
+        slots[slot] = id;
+    }
+}
+
+// bind a prefix to a namespace, with a prefix bound to a srcML namespace resolved to its usual prefix
+void NameTable::bindPrefix(std::string_view prefix, std::string_view uri) {
+
+    if (!isBound(prefix))
+        declaredPrefixes.emplace_back(prefix);
+
+    const auto srcMLNamespace = std::find_if(SRCML_NAMESPACES.cbegin(), SRCML_NAMESPACES.cend(),
+        [uri](const auto& entry) { return entry.first == uri; });
+
+    // a later binding of the prefix replaces an earlier one
+    boundPrefixes.erase(std::remove_if(boundPrefixes.begin(), boundPrefixes.end(),
+        [prefix](const auto& binding) { return binding.first == prefix; }), boundPrefixes.end());
+    if (srcMLNamespace != SRCML_NAMESPACES.cend() && srcMLNamespace->second != prefix)
+        boundPrefixes.emplace_back(std::string(prefix), srcMLNamespace->second);
+}
+
+// if the prefix is bound to a namespace
+bool NameTable::isBound(std::string_view prefix) const {
+
+    return std::find(declaredPrefixes.cbegin(), declaredPrefixes.cend(), prefix) != declaredPrefixes.cend();
+}
+
+// usual srcML prefix of a prefix bound to a srcML namespace, otherwise the prefix
+std::string_view NameTable::resolvePrefix(std::string_view prefix) const {
+
+    for (const auto& [boundPrefix, srcMLPrefix] : boundPrefixes) {
+        if (boundPrefix == prefix)
+            return srcMLPrefix;
+    }
+    return prefix;
+}
+
+// number of names in the table
+int NameTable::size() const {
+
+    return static_cast<int>(names.size());
+}
+
+// prefix of the name with the ID
+std::string_view NameTable::prefix(int id) const {
+
+    return names[id].prefix;
+}
+
+// local name of the name with the ID
+std::string_view NameTable::localName(int id) const {
+
+    return names[id].localName;
+}
+
+// add a new name at the empty slot
+int NameTable::insert(std::size_t slot, std::string_view prefix, std::string_view localName) {
+
+    // copy the name, as the views are into the parser content
+    const std::string& qName = storage.emplace_back(std::string(prefix).append(localName));
+    const std::string_view qNameView(qName);
+    const int id = static_cast<int>(names.size());
+    names.push_back({ qNameView.substr(0, prefix.size()), qNameView.substr(prefix.size()) });
+    slots[slot] = id;
+
+    // keep the table at most half full
+    if (names.size() * 2 > slots.size())
+        grow();
+
+    return id;
+}
+
+// double the number of slots
+void NameTable::grow() {
+
+    slots.assign(slots.size() * 2, EMPTY_SLOT);
+    mask = slots.size() - 1;
+    for (int id = 0; id < static_cast<int>(names.size()); ++id) {
+        std::size_t slot = hashName(names[id].prefix, names[id].localName) & mask;
+        while (slots[slot] != EMPTY_SLOT)
+            slot = (slot + 1) & mask;
+        slots[slot] = id;
+    }
+}
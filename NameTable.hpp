@@ -0,0 +1,254 @@
+/*
+    NameTable.hpp
+
+    Include file for the table of interned element and attribute names.
+
+    Each name, a prefix and a local name, has a dense integer ID. The names
+    of the srcML vocabulary have IDs fixed at compile time, e.g., NameTable::EXPR,
+    so handlers can index arrays by the ID instead of comparing strings.
+    Other names are added as they are found, with IDs after the srcML names.
+    The IDs of other names are only the same within one table.
+
+    The srcML names are registered with the usual srcML prefixes, i.e., none,
+    cpp, and pos. A document can bind other prefixes to the srcML namespaces,
+    e.g., xmlns:src, so a prefix bound to a srcML namespace is resolved to the
+    usual prefix of that namespace before the name is looked up.
+*/
+
+#ifndef INCLUDED_NAMETABLE_HPP
+#define INCLUDED_NAMETABLE_HPP
+
+#include <string_view>
+#include <string>
+#include <vector>
+#include <deque>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+// srcML vocabulary of element and attribute names as NAME(ID, prefix, localName)
+#define SRCML_NAMES(NAME) \
+    NAME(UNIT, "", "unit") \
+    NAME(EXPR, "", "expr") \
+    NAME(EXPR_STMT, "", "expr_stmt") \
+    NAME(DECL, "", "decl") \
+    NAME(DECL_STMT, "", "decl_stmt") \
+    NAME(INIT, "", "init") \
+    NAME(FUNCTION, "", "function") \
+    NAME(FUNCTION_DECL, "", "function_decl") \
+    NAME(CONSTRUCTOR, "", "constructor") \
+    NAME(CONSTRUCTOR_DECL, "", "constructor_decl") \
+    NAME(DESTRUCTOR, "", "destructor") \
+    NAME(DESTRUCTOR_DECL, "", "destructor_decl") \
+    NAME(CLASS, "", "class") \
+    NAME(CLASS_DECL, "", "class_decl") \
+    NAME(STRUCT, "", "struct") \
+    NAME(STRUCT_DECL, "", "struct_decl") \
+    NAME(UNION, "", "union") \
+    NAME(ENUM, "", "enum") \
+    NAME(NAMESPACE, "", "namespace") \
+    NAME(USING, "", "using") \
+    NAME(TYPEDEF, "", "typedef") \
+    NAME(TEMPLATE, "", "template") \
+    NAME(RETURN, "", "return") \
+    NAME(COMMENT, "", "comment") \
+    NAME(NAME, "", "name") \
+    NAME(TYPE, "", "type") \
+    NAME(SPECIFIER, "", "specifier") \
+    NAME(MODIFIER, "", "modifier") \
+    NAME(BLOCK, "", "block") \
+    NAME(BLOCK_CONTENT, "", "block_content") \
+    NAME(IF_STMT, "", "if_stmt") \
+    NAME(IF, "", "if") \
+    NAME(ELSE, "", "else") \
+    NAME(THEN, "", "then") \
+    NAME(WHILE, "", "while") \
+    NAME(FOR, "", "for") \
+    NAME(DO, "", "do") \
+    NAME(CONTROL, "", "control") \
+    NAME(CONDITION, "", "condition") \
+    NAME(INCR, "", "incr") \
+    NAME(SWITCH, "", "switch") \
+    NAME(CASE, "", "case") \
+    NAME(DEFAULT, "", "default") \
+    NAME(BREAK, "", "break") \
+    NAME(CONTINUE, "", "continue") \
+    NAME(GOTO, "", "goto") \
+    NAME(LABEL, "", "label") \
+    NAME(EMPTY_STMT, "", "empty_stmt") \
+    NAME(CALL, "", "call") \
+    NAME(ARGUMENT_LIST, "", "argument_list") \
+    NAME(ARGUMENT, "", "argument") \
+    NAME(PARAMETER_LIST, "", "parameter_list") \
+    NAME(PARAMETER, "", "parameter") \
+    NAME(OPERATOR, "", "operator") \
+    NAME(LITERAL, "", "literal") \
+    NAME(INDEX, "", "index") \
+    NAME(TERNARY, "", "ternary") \
+    NAME(TRY, "", "try") \
+    NAME(CATCH, "", "catch") \
+    NAME(THROW, "", "throw") \
+    NAME(MEMBER_INIT_LIST, "", "member_init_list") \
+    NAME(SUPER_LIST, "", "super_list") \
+    NAME(SUPER, "", "super") \
+    NAME(PUBLIC, "", "public") \
+    NAME(PRIVATE, "", "private") \
+    NAME(PROTECTED, "", "protected") \
+    NAME(LAMBDA, "", "lambda") \
+    NAME(CAPTURE, "", "capture") \
+    NAME(SIZEOF, "", "sizeof") \
+    NAME(DECLTYPE, "", "decltype") \
+    NAME(RANGE, "", "range") \
+    NAME(MACRO, "", "macro") \
+    NAME(ESCAPE, "", "escape") \
+    NAME(ANNOTATION, "", "annotation") \
+    NAME(IMPORT, "", "import") \
+    NAME(PACKAGE, "", "package") \
+    NAME(EXTENDS, "", "extends") \
+    NAME(IMPLEMENTS, "", "implements") \
+    NAME(CPP_INCLUDE, "cpp", "include") \
+    NAME(CPP_DEFINE, "cpp", "define") \
+    NAME(CPP_UNDEF, "cpp", "undef") \
+    NAME(CPP_DIRECTIVE, "cpp", "directive") \
+    NAME(CPP_FILE, "cpp", "file") \
+    NAME(CPP_MACRO, "cpp", "macro") \
+    NAME(CPP_VALUE, "cpp", "value") \
+    NAME(CPP_IF, "cpp", "if") \
+    NAME(CPP_IFDEF, "cpp", "ifdef") \
+    NAME(CPP_IFNDEF, "cpp", "ifndef") \
+    NAME(CPP_ELIF, "cpp", "elif") \
+    NAME(CPP_ELSE, "cpp", "else") \
+    NAME(CPP_ENDIF, "cpp", "endif") \
+    NAME(CPP_PRAGMA, "cpp", "pragma") \
+    NAME(CPP_ERROR, "cpp", "error") \
+    NAME(CPP_WARNING, "cpp", "warning") \
+    NAME(CPP_LINE, "cpp", "line") \
+    NAME(CPP_NUMBER, "cpp", "number") \
+    NAME(URL, "", "url") \
+    NAME(FILENAME, "", "filename") \
+    NAME(LANGUAGE, "", "language") \
+    NAME(REVISION, "", "revision") \
+    NAME(VERSION, "", "version") \
+    NAME(TIMESTAMP, "", "timestamp") \
+    NAME(HASH, "", "hash") \
+    NAME(ITEM, "", "item") \
+    NAME(OPTIONS, "", "options") \
+    NAME(TABS, "", "tabs") \
+    NAME(SRC_ENCODING, "", "src-encoding") \
+    NAME(CHAR, "", "char") \
+    NAME(POS_START, "pos", "start") \
+    NAME(POS_END, "pos", "end") \
+    NAME(POS_TABS, "pos", "tabs")
+
+class NameTable {
+
+    public:
+
+    // IDs of the srcML names
+    enum : int {
+#define SRCML_NAME_ID(id, prefix, localName) id,
+        SRCML_NAMES(SRCML_NAME_ID)
+#undef SRCML_NAME_ID
+        SRCML_NAME_COUNT
+    };
+
+    NameTable();
+
+    /*
+        ID of the name, with a new name added to the table
+
+        @param prefix Prefix of the name, empty if none
+        @param localName Local name
+        @return ID of the name
+    */
+    [[nodiscard]] int intern(std::string_view prefix, std::string_view localName) {
+
+        if (!boundPrefixes.empty())
+            prefix = resolvePrefix(prefix);
+
+        for (std::size_t slot = hashName(prefix, localName) & mask; ; slot = (slot + 1) & mask) {
+            const int id = slots[slot];
+            if (id == EMPTY_SLOT)
+                return insert(slot, prefix, localName);
+            if (names[id].localName == localName && names[id].prefix == prefix)
+                return id;
+        }
+    }
+
+    /*
+        Bind a prefix to a namespace, so that names with a prefix bound to a srcML
+        namespace have the IDs of the srcML names. Bindings are for the whole
+        document, as srcML declares its namespaces on the root unit.
+
+        @param prefix Prefix of the namespace declaration, empty for the default namespace
+        @param uri URI of the namespace
+    */
+    void bindPrefix(std::string_view prefix, std::string_view uri);
+
+    // if the prefix is bound to a namespace
+    [[nodiscard]] bool isBound(std::string_view prefix) const;
+
+    // number of names in the table
+    [[nodiscard]] int size() const;
+
+    // prefix of the name with the ID
+    [[nodiscard]] std::string_view prefix(int id) const;
+
+    // local name of the name with the ID
+    [[nodiscard]] std::string_view localName(int id) const;
+
+    private:
+
+    struct Name {
+        std::string_view prefix;
+        std::string_view localName;
+    };
+
+    // srcML names in the order of their IDs
+    static constexpr std::array<Name, SRCML_NAME_COUNT> SRCML = {{
+#define SRCML_NAME_ENTRY(id, prefix, localName) { prefix, localName },
+        SRCML_NAMES(SRCML_NAME_ENTRY)
+#undef SRCML_NAME_ENTRY
+    }};
+
+    static constexpr int EMPTY_SLOT = -1;
+
+    // hash of the prefix and local name from their sizes and sampled characters,
+    // as names are short and hashing every character costs more than a rare collision
+    static constexpr std::uint32_t hashName(std::string_view prefix, std::string_view localName) {
+
+        std::uint32_t hash = static_cast<std::uint32_t>(localName.size());
+        if (!localName.empty()) {
+            hash ^= static_cast<std::uint32_t>(static_cast<unsigned char>(localName.front())) << 6;
+            hash ^= static_cast<std::uint32_t>(static_cast<unsigned char>(localName[localName.size() / 2])) << 13;
+            hash ^= static_cast<std::uint32_t>(static_cast<unsigned char>(localName.back())) << 20;
+        }
+        if (!prefix.empty())
+            hash ^= (static_cast<std::uint32_t>(static_cast<unsigned char>(prefix.front())) << 26) ^ (static_cast<std::uint32_t>(prefix.size()) << 3);
+        return (hash * 2654435761U) >> 12;
+    }
+
+    // usual srcML prefix of a prefix bound to a srcML namespace, otherwise the prefix
+    [[nodiscard]] std::string_view resolvePrefix(std::string_view prefix) const;
+
+    // add a new name at the empty slot
+    int insert(std::size_t slot, std::string_view prefix, std::string_view localName);
+
+    // double the number of slots
+    void grow();
+
+    std::vector<Name> names;
+    std::vector<int> slots;
+    std::size_t mask;
+
+    // storage for the new names, stable for the views in names
+    std::deque<std::string> storage;
+
+    // prefixes bound to a srcML namespace that are not its usual prefix, with the usual prefix
+    std::vector<std::pair<std::string, std::string_view>> boundPrefixes;
+
+    // all prefixes bound to a namespace
+    std::vector<std::string> declaredPrefixes;
+};
+
+#endif
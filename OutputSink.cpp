@@ -0,0 +1,102 @@
+/*
+    OutputSink.cpp
+
+    Implementation file for buffered output to a file descriptor
+*/
+
+#include "OutputSink.hpp"
+#include <iostream>
+#include <cerrno>
+#include <cstdlib>
+
+#if !defined(_MSC_VER)
+#include <sys/uio.h>
+#include <unistd.h>
+#else
+#include <BaseTsd.h>
+#include <io.h>
+typedef SSIZE_T ssize_t;
+#endif
+
+namespace {
+
+    // piece of output for writeAll()
+    struct Piece {
+        const char* data;
+        std::size_t size;
+    };
+
+    // write all of the pieces in order, continuing after interrupts and partial writes
+    void writeAll(int fd, Piece* pieces, int count) {
+
+        while (count > 0) {
+            if (pieces[0].size == 0) {
+                ++pieces;
+                --count;
+                continue;
+            }
+#if !defined(_MSC_VER)
+            iovec iov[2];
+            for (int i = 0; i < count; ++i)
+                iov[i] = { const_cast<char*>(pieces[i].data), pieces[i].size };
+            const ssize_t bytesWritten = writev(fd, iov, count);
+#else
+            const ssize_t bytesWritten = _write(fd, pieces[0].data, static_cast<unsigned int>(pieces[0].size));
+#endif
+            if (bytesWritten == -1) {
+                if (errno == EINTR)
+                    continue;
+                std::cerr << "output error : Write failed\n";
+                exit(1);
+            }
+
+            // skip the written part of the pieces
+            std::size_t written = static_cast<std::size_t>(bytesWritten);
+            while (count > 0 && written >= pieces[0].size) {
+                written -= pieces[0].size;
+                ++pieces;
+                --count;
+            }
+            if (count > 0) {
+                pieces[0].data += written;
+                pieces[0].size -= written;
+            }
+        }
+    }
+}
+
+// constructor
+OutputSink::OutputSink(int fd, std::size_t bufferSize)
+    : fd(fd), bufferSize(bufferSize), buffer(new (std::align_val_t(BUFFER_ALIGNMENT)) char[bufferSize]) {
+}
+
+// destructor, with the remaining output written
+OutputSink::~OutputSink() {
+
+    flush();
+}
+
+// write the buffered output
+void OutputSink::flush() {
+
+    Piece pieces[] = { { buffer.get(), used } };
+    writeAll(fd, pieces, 1);
+    used = 0;
+}
+
+// write the buffered output and a fragment that does not fit in the buffer
+void OutputSink::writeLarge(std::string_view data) {
+
+    // smaller fragments are copied into the emptied buffer
+    if (data.size() < DIRECT_SIZE && data.size() <= bufferSize) {
+        flush();
+        std::memcpy(buffer.get(), data.data(), data.size());
+        used = data.size();
+        return;
+    }
+
+    // larger fragments are written directly from their own storage
+    Piece pieces[] = { { buffer.get(), used }, { data.data(), data.size() } };
+    writeAll(fd, pieces, 2);
+    used = 0;
+}
@@ -0,0 +1,80 @@
+/*
+    OutputSink.hpp
+
+    Include file for buffered output to a file descriptor.
+
+    Small fragments are collected into a large aligned buffer. Large fragments
+    are not copied, but written directly with the buffer in one writev(),
+    so the fragment only has to be valid during the call. Output is only
+    appended, and works the same for files, pipes, and terminals.
+*/
+
+#ifndef INCLUDED_OUTPUTSINK_HPP
+#define INCLUDED_OUTPUTSINK_HPP
+
+#include <string_view>
+#include <memory>
+#include <new>
+#include <cstring>
+
+class OutputSink {
+
+    public:
+
+    static constexpr std::size_t DEFAULT_OUTPUT_BUFFER_SIZE = 16 * 16 * 4096;
+
+    // constructor
+    explicit OutputSink(int fd = 1, std::size_t bufferSize = DEFAULT_OUTPUT_BUFFER_SIZE);
+
+    OutputSink(const OutputSink&) = delete;
+
+    OutputSink& operator=(const OutputSink&) = delete;
+
+    // destructor, with the remaining output written
+    ~OutputSink();
+
+    // append the data to the output
+    void write(std::string_view data) {
+
+        if (data.size() > bufferSize - used || data.size() >= DIRECT_SIZE) {
+            writeLarge(data);
+            return;
+        }
+        std::memcpy(buffer.get() + used, data.data(), data.size());
+        used += data.size();
+    }
+
+    // append the character to the output
+    void write(char c) {
+
+        if (used == bufferSize)
+            flush();
+        buffer[used++] = c;
+    }
+
+    // write the buffered output
+    void flush();
+
+    private:
+
+    // fragments at least this size are written directly instead of copied
+    static constexpr std::size_t DIRECT_SIZE = 16 * 4096;
+
+    // alignment of the buffer, for whole pages
+    static constexpr std::size_t BUFFER_ALIGNMENT = 4096;
+
+    // delete for the aligned buffer
+    struct AlignedDelete {
+        void operator()(char* p) const { ::operator delete[](p, std::align_val_t(BUFFER_ALIGNMENT)); }
+    };
+
+    // write the buffered output and a fragment that does not fit in the buffer
+    void writeLarge(std::string_view data);
+
+    int fd;
+    std::size_t bufferSize;
+    std::size_t used = 0;
+    std::unique_ptr<char[], AlignedDelete> buffer;
+};
+
+#endif
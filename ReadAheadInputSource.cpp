@@ -0,0 +1,197 @@
+/*
+    ReadAheadInputSource.cpp
+
+    Implementation file for an input source with a reader thread that reads ahead
+    of the parser
+*/
+
+#include "ReadAheadInputSource.hpp"
+#include <algorithm>
+#include <cerrno>
+
+#if !defined(_MSC_VER)
+#include <unistd.h>
+#define READ read
+#define CLOSE close
+#else
+#include <BaseTsd.h>
+#include <io.h>
+typedef SSIZE_T ssize_t;
+#define READ _read
+#define CLOSE _close
+#endif
+
+namespace {
+
+    const std::size_t BLOCK_SIZE = 4096;
+
+    // polls of a counter before a side blocks, enough for the other side to finish a short step
+    const int SPIN_COUNT = 100;
+}
+
+namespace {
+
+    // file descriptor closed with its producer
+    struct FileReader {
+        int fd;
+        bool ownsFD;
+
+        FileReader(int fd, bool ownsFD) : fd(fd), ownsFD(ownsFD) {}
+
+        FileReader(const FileReader&) = delete;
+
+        FileReader& operator=(const FileReader&) = delete;
+
+        ~FileReader() {
+            if (ownsFD)
+                CLOSE(fd);
+        }
+    };
+}
+
+// constructor, starting the reader thread
+ReadAheadInputSource::ReadAheadInputSource(int fd, std::size_t bufferSize, std::size_t slotCount, bool ownsFD)
+    : ReadAheadInputSource([file = std::make_shared<FileReader>(fd, ownsFD)](char* data, std::size_t size) {
+
+        ssize_t bytesRead = 0;
+        while (((bytesRead = READ(file->fd, data, size)) == -1) && (errno == EINTR)) {
+        }
+        return static_cast<long>(bytesRead);
+    }, "read-ahead", bufferSize, slotCount) {}
+
+// constructor, starting the reader thread with a producer
+ReadAheadInputSource::ReadAheadInputSource(Producer produce, std::string modeName, std::size_t bufferSize, std::size_t slotCount)
+    : produce(std::move(produce)), modeName(std::move(modeName)), slots(std::max<std::size_t>(2, slotCount)) {
+
+    // read in multiple of whole blocks
+    readSize = std::max(BLOCK_SIZE, bufferSize - bufferSize % BLOCK_SIZE);
+    headroom = readSize;
+    for (auto& slot : slots)
+        slot.buffer.reset(new char[headroom + readSize + BLOCK_SIZE]());
+
+    reader = std::thread(&ReadAheadInputSource::readAhead, this);
+}
+
+// destructor
+ReadAheadInputSource::~ReadAheadInputSource() {
+
+    stopping.store(true);
+    {
+        const std::lock_guard<std::mutex> lock(waitMutex);
+    }
+    slotReleased.notify_one();
+    reader.join();
+}
+
+// start of the data of the slot
+[[nodiscard]] char* ReadAheadInputSource::slotData(std::uint64_t slot) const {
+
+    return slots[slot % slots.size()].buffer.get() + headroom;
+}
+
+// fill the slots in order until EOF, an error, or stopping
+void ReadAheadInputSource::readAhead() {
+
+    for (std::uint64_t slot = 0; ; ++slot) {
+
+        // wait for a free slot, the parser keeps the slot after the released ones
+        auto hasFreeSlot = [&]() { return slot - released.load() < slots.size() || stopping.load(); };
+        for (int spin = 0; !hasFreeSlot(); ++spin) {
+            if (spin < SPIN_COUNT) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(waitMutex);
+            readerWaiting.store(true);
+            slotReleased.wait(lock, hasFreeSlot);
+            readerWaiting.store(false);
+        }
+        if (stopping.load(std::memory_order_acquire))
+            return;
+
+        const long bytesRead = produce(slotData(slot), readSize);
+        slots[slot % slots.size()].bytesRead = bytesRead;
+        filled.store(slot + 1);
+
+        // the flag is checked after the store, so a parser that blocks sees the slot, or is notified
+        if (parserWaiting.load()) {
+            {
+                const std::lock_guard<std::mutex> lock(waitMutex);
+            }
+            slotFilled.notify_one();
+        }
+
+        // EOF or error is the last slot
+        if (bytesRead <= 0)
+            return;
+    }
+}
+
+/*
+    Refill the content preserving the existing data.
+
+    The unprocessed content is copied into the headroom of the next filled slot,
+    directly before its data, and the current slot is released to the reader thread.
+
+    @param[in, out] content View of the content
+    @return Number of bytes read
+    @retval 0 EOF
+    @retval -1 Read error, or the unprocessed content does not fit the headroom
+*/
+[[nodiscard]] long ReadAheadInputSource::refill(std::string_view& content) {
+
+    if (done)
+        return 0;
+
+    if (content.size() > headroom)
+        return -1;
+
+    // wait for the reader thread to fill the next slot
+    const std::uint64_t current = released.load(std::memory_order_relaxed);
+    const std::uint64_t next = hasSlot ? current + 1 : current;
+    auto isFilled = [&]() { return filled.load() > next; };
+    for (int spin = 0; !isFilled(); ++spin) {
+        if (spin < SPIN_COUNT) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(waitMutex);
+        parserWaiting.store(true);
+        slotFilled.wait(lock, isFilled);
+        parserWaiting.store(false);
+    }
+
+    // EOF or error, keep the content in the current slot
+    const long bytesRead = slots[next % slots.size()].bytesRead;
+    if (bytesRead <= 0) {
+        done = true;
+        return bytesRead;
+    }
+
+    // preserve the unprocessed content directly before the new data
+    char* data = slotData(next);
+    std::copy(content.cbegin(), content.cend(), data - content.size());
+    content = std::string_view(data - content.size(), content.size() + bytesRead);
+
+    // release the current slot to the reader thread
+    if (hasSlot) {
+        released.store(next);
+
+        // the flag is checked after the store, so a reader that blocks sees the slot, or is notified
+        if (readerWaiting.load()) {
+            {
+                const std::lock_guard<std::mutex> lock(waitMutex);
+            }
+            slotReleased.notify_one();
+        }
+    }
+    hasSlot = true;
+
+    return bytesRead;
+}
+
+// name of the input mode
+[[nodiscard]] std::string_view ReadAheadInputSource::mode() const {
+
+    return modeName;
+}
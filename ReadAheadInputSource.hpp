@@ -0,0 +1,126 @@
+/*
+    ReadAheadInputSource.hpp
+
+    Include file for an input source with a reader thread that reads ahead
+    of the parser.
+
+    The reader thread fills a ring of slots while the parser works on the
+    current slot. The handoff is single-producer/single-consumer with atomic
+    counters of the filled and released slots, so neither side takes a lock
+    while the other keeps up. A side that has to wait spins briefly, then
+    blocks on a condition variable, so a slow pipe does not keep a core busy.
+    The other side only locks to notify when a side is blocked.
+    Each slot has headroom before its data, where a refill copies the
+    unprocessed content of the current slot, and a block of zeros after its
+    data for lookahead past the content.
+
+    By default the reader thread reads from a file descriptor. A producer
+    function can fill the slots instead, e.g., with decompressed input.
+*/
+
+#ifndef INCLUDED_READAHEADINPUTSOURCE_HPP
+#define INCLUDED_READAHEADINPUTSOURCE_HPP
+
+#include "InputSource.hpp"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
+
+class ReadAheadInputSource : public InputSource {
+
+    public:
+
+    /*
+        Fill the data of a slot, called on the reader thread
+
+        @param data Start of the data of the slot
+        @param size Size of the data of the slot
+        @return Number of bytes produced
+        @retval 0 EOF
+        @retval -1 Error
+    */
+    using Producer = std::function<long(char* data, std::size_t size)>;
+
+    private:
+
+    // slot of the ring, with the data read at start + headroom
+    struct Slot {
+        std::unique_ptr<char[]> buffer;
+        long bytesRead = 0;
+    };
+
+    Producer produce;
+    std::string modeName;
+    std::size_t readSize;
+    std::size_t headroom;
+    std::vector<Slot> slots;
+
+    // number of slots filled by the reader thread
+    std::atomic<std::uint64_t> filled{0};
+
+    // number of slots released by the parser, which is working on the next one
+    std::atomic<std::uint64_t> released{0};
+
+    // parser has a slot, i.e., after the first refill
+    bool hasSlot = false;
+
+    // reader thread found EOF or an error
+    bool done = false;
+
+    // reader thread is asked to stop
+    std::atomic<bool> stopping{false};
+
+    // blocking wait of a side that did not get a slot while spinning
+    std::mutex waitMutex;
+    std::condition_variable slotFilled;
+    std::condition_variable slotReleased;
+    std::atomic<bool> parserWaiting{false};
+    std::atomic<bool> readerWaiting{false};
+
+    std::thread reader;
+
+    // fill the slots in order until EOF, an error, or stopping
+    void readAhead();
+
+    // start of the data of the slot
+    [[nodiscard]] char* slotData(std::uint64_t slot) const;
+
+    public:
+
+    /*
+        Constructor, starting the reader thread
+
+        @param fd File descriptor to read from
+        @param bufferSize Size of each read, and of the headroom for unprocessed content
+        @param slotCount Number of slots in the ring, at least 2 for double buffering
+        @param ownsFD Close the file descriptor in the destructor
+    */
+    ReadAheadInputSource(int fd = 0, std::size_t bufferSize = DEFAULT_BUFFER_SIZE, std::size_t slotCount = 4, bool ownsFD = false);
+
+    /*
+        Constructor, starting the reader thread with a producer
+
+        @param produce Producer that fills the slots
+        @param modeName Name of the input mode
+        @param bufferSize Size of the data of each slot, and of the headroom for unprocessed content
+        @param slotCount Number of slots in the ring, at least 2 for double buffering
+    */
+    ReadAheadInputSource(Producer produce, std::string modeName, std::size_t bufferSize = DEFAULT_BUFFER_SIZE, std::size_t slotCount = 4);
+
+    ReadAheadInputSource(const ReadAheadInputSource&) = delete;
+
+    ReadAheadInputSource& operator=(const ReadAheadInputSource&) = delete;
+
+    ~ReadAheadInputSource() override;
+
+    [[nodiscard]] long refill(std::string_view& content) override;
+
+    [[nodiscard]] std::string_view mode() const override;
+};
+
+#endif
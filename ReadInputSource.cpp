@@ -0,0 +1,43 @@
+/*
+    ReadInputSource.cpp
+
+    Implementation file for an input source that reads a file descriptor into a buffer
+*/
+
+#include "ReadInputSource.hpp"
+#include "refillContent.hpp"
+
+#if !defined(_MSC_VER)
+#include <unistd.h>
+#define CLOSE close
+#else
+#include <io.h>
+#define CLOSE _close
+#endif
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+// constructor
+ReadInputSource::ReadInputSource(int fd, std::size_t bufferSize, bool ownsFD)
+    : fd(fd), ownsFD(ownsFD), bufferSize(bufferSize), buffer(new char[bufferSize]()) {
+}
+
+// destructor
+ReadInputSource::~ReadInputSource() {
+
+    if (ownsFD)
+        CLOSE(fd);
+}
+
+// refill the content preserving the existing data
+[[nodiscard]] long ReadInputSource::refill(std::string_view& content) {
+
+    return refillContent(fd, buffer.get(), bufferSize, content);
+}
+
+// name of the input mode
+[[nodiscard]] std::string_view ReadInputSource::mode() const {
+
+    return "read"sv;
+}
@@ -0,0 +1,37 @@
+/*
+    ReadInputSource.hpp
+
+    Include file for an input source that reads a file descriptor into a buffer
+*/
+
+#ifndef INCLUDED_READINPUTSOURCE_HPP
+#define INCLUDED_READINPUTSOURCE_HPP
+
+#include "InputSource.hpp"
+
+class ReadInputSource : public InputSource {
+
+    private:
+
+    int fd;
+    bool ownsFD;
+    std::size_t bufferSize;
+    std::unique_ptr<char[]> buffer;
+
+    public:
+
+    // constructor
+    ReadInputSource(int fd = 0, std::size_t bufferSize = DEFAULT_BUFFER_SIZE, bool ownsFD = false);
+
+    ReadInputSource(const ReadInputSource&) = delete;
+
+    ReadInputSource& operator=(const ReadInputSource&) = delete;
+
+    ~ReadInputSource() override;
+
+    [[nodiscard]] long refill(std::string_view& content) override;
+
+    [[nodiscard]] std::string_view mode() const override;
+};
+
+#endif
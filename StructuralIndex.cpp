@@ -0,0 +1,240 @@
+/*
+    StructuralIndex.cpp
+
+    Implementation file for a two-stage structural index of the content.
+    Uses AVX2 or SSE2 when available, selected at runtime.
+*/
+
+#include "StructuralIndex.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define INDEX_X86
+#include <immintrin.h>
+#endif
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // bits of each character for the bitmaps it is in
+    struct CharacterClasses {
+        std::array<std::uint8_t, 256> bitmaps{};
+
+        constexpr CharacterClasses() {
+            for (const char c : "<&"sv)
+                bitmaps[static_cast<unsigned char>(c)] |= 1U << StructuralIndex::CHARACTER_END;
+            for (const char c : "> /\":=\n\t\r"sv)
+                bitmaps[static_cast<unsigned char>(c)] |= 1U << StructuralIndex::NAME_END;
+            bitmaps[static_cast<unsigned char>('>')] |= 1U << StructuralIndex::TAG_END;
+            for (const char c : "\"'"sv)
+                bitmaps[static_cast<unsigned char>(c)] |= 1U << StructuralIndex::QUOTE;
+        }
+    };
+
+    constexpr CharacterClasses CLASSES;
+
+    // scalar classification of the blocks
+    void classifyScalar(const char* data, std::size_t blockCount, StructuralIndex::BlockBitmaps* blocks) {
+
+        for (std::size_t block = 0; block < blockCount; ++block) {
+            StructuralIndex::BlockBitmaps bitmaps{};
+            for (std::size_t i = 0; i < 64; ++i) {
+                const unsigned classes = CLASSES.bitmaps[static_cast<unsigned char>(data[block * 64 + i])];
+                for (int bitmap = 0; bitmap < StructuralIndex::BITMAP_COUNT; ++bitmap)
+                    bitmaps[bitmap] |= static_cast<std::uint64_t>((classes >> bitmap) & 1U) << i;
+            }
+            blocks[block] = bitmaps;
+        }
+    }
+
+#ifdef INDEX_X86
+
+    // classification of 16 bytes into masks of the bitmaps
+    inline void classifySSE2(__m128i bytes, unsigned masks[StructuralIndex::BITMAP_COUNT]) {
+
+        const __m128i greater = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('>'));
+        const __m128i doubleQuote = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('"'));
+        const __m128i characterEnd = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('<')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('&')));
+        const __m128i quote = _mm_or_si128(doubleQuote, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\'')));
+        __m128i nameEnd = _mm_or_si128(greater, doubleQuote);
+        nameEnd = _mm_or_si128(nameEnd, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')));
+        nameEnd = _mm_or_si128(nameEnd, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('/')));
+        nameEnd = _mm_or_si128(nameEnd, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(':')));
+        nameEnd = _mm_or_si128(nameEnd, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('=')));
+        nameEnd = _mm_or_si128(nameEnd, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')));
+        nameEnd = _mm_or_si128(nameEnd, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t')));
+        nameEnd = _mm_or_si128(nameEnd, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r')));
+        masks[StructuralIndex::CHARACTER_END] = static_cast<unsigned>(_mm_movemask_epi8(characterEnd));
+        masks[StructuralIndex::NAME_END] = static_cast<unsigned>(_mm_movemask_epi8(nameEnd));
+        masks[StructuralIndex::TAG_END] = static_cast<unsigned>(_mm_movemask_epi8(greater));
+        masks[StructuralIndex::QUOTE] = static_cast<unsigned>(_mm_movemask_epi8(quote));
+    }
+
+    void classifySSE2(const char* data, std::size_t blockCount, StructuralIndex::BlockBitmaps* blocks) {
+
+        for (std::size_t block = 0; block < blockCount; ++block) {
+            StructuralIndex::BlockBitmaps bitmaps{};
+            for (int part = 0; part < 4; ++part) {
+                unsigned masks[StructuralIndex::BITMAP_COUNT];
+                classifySSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + block * 64 + part * 16)), masks);
+                for (int bitmap = 0; bitmap < StructuralIndex::BITMAP_COUNT; ++bitmap)
+                    bitmaps[bitmap] |= static_cast<std::uint64_t>(masks[bitmap]) << (part * 16);
+            }
+            blocks[block] = bitmaps;
+        }
+    }
+
+    // classification of 32 bytes into masks of the bitmaps
+    __attribute__((target("avx2")))
+    inline void classifyAVX2(__m256i bytes, std::uint32_t masks[StructuralIndex::BITMAP_COUNT]) {
+
+        const __m256i greater = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('>'));
+        const __m256i doubleQuote = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('"'));
+        const __m256i characterEnd = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('<')), _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('&')));
+        const __m256i quote = _mm256_or_si256(doubleQuote, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\'')));
+        __m256i nameEnd = _mm256_or_si256(greater, doubleQuote);
+        nameEnd = _mm256_or_si256(nameEnd, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')));
+        nameEnd = _mm256_or_si256(nameEnd, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('/')));
+        nameEnd = _mm256_or_si256(nameEnd, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(':')));
+        nameEnd = _mm256_or_si256(nameEnd, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('=')));
+        nameEnd = _mm256_or_si256(nameEnd, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n')));
+        nameEnd = _mm256_or_si256(nameEnd, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\t')));
+        nameEnd = _mm256_or_si256(nameEnd, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\r')));
+        masks[StructuralIndex::CHARACTER_END] = static_cast<std::uint32_t>(_mm256_movemask_epi8(characterEnd));
+        masks[StructuralIndex::NAME_END] = static_cast<std::uint32_t>(_mm256_movemask_epi8(nameEnd));
+        masks[StructuralIndex::TAG_END] = static_cast<std::uint32_t>(_mm256_movemask_epi8(greater));
+        masks[StructuralIndex::QUOTE] = static_cast<std::uint32_t>(_mm256_movemask_epi8(quote));
+    }
+
+    __attribute__((target("avx2")))
+    void classifyAVX2(const char* data, std::size_t blockCount, StructuralIndex::BlockBitmaps* blocks) {
+
+        for (std::size_t block = 0; block < blockCount; ++block) {
+            std::uint32_t low[StructuralIndex::BITMAP_COUNT];
+            std::uint32_t high[StructuralIndex::BITMAP_COUNT];
+            classifyAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + block * 64)), low);
+            classifyAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + block * 64 + 32)), high);
+            for (int bitmap = 0; bitmap < StructuralIndex::BITMAP_COUNT; ++bitmap)
+                blocks[block][bitmap] = low[bitmap] | (static_cast<std::uint64_t>(high[bitmap]) << 32);
+        }
+    }
+#endif
+
+    // classification functions for an instruction set
+    struct Classifier {
+        void (*classify)(const char*, std::size_t, StructuralIndex::BlockBitmaps*);
+        std::string_view instructionSet;
+    };
+
+    // select the classification for this processor
+    Classifier selectClassifier() {
+
+#ifdef INDEX_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return { classifyAVX2, "avx2"sv };
+
+        // SSE2 is part of x86-64
+        return { classifySSE2, "sse2"sv };
+#else
+        return { classifyScalar, "scalar"sv };
+#endif
+    }
+
+    const Classifier classifier = selectClassifier();
+}
+
+// stage one, classify the window starting at the position up to the end of the content
+void StructuralIndex::classify(const char* start, const char* end) {
+
+    const std::size_t size = std::min(static_cast<std::size_t>(end - start), WINDOW_BLOCKS * 64);
+    base = start;
+    windowEnd = start + size;
+    contentEnd = end;
+
+    // full blocks
+    const std::size_t blockCount = size / 64;
+    classifier.classify(start, blockCount, blocks.data());
+
+    // last partial block, padded with characters not in any bitmap
+    if (size % 64) {
+        char padded[64] = {};
+        std::memcpy(padded, start + blockCount * 64, size % 64);
+        classifyScalar(padded, 1, blocks.data() + blockCount);
+    }
+}
+
+// find past the position in the window, classifying the next windows as needed
+[[nodiscard]] std::size_t StructuralIndex::findAfterWindow(Bitmap bitmap, std::string_view content, std::size_t pos) {
+
+    const char* end = content.data() + content.size();
+    const char* position = content.data() + pos;
+    if (position >= end)
+        return std::string_view::npos;
+
+    // a window for other content, or not containing the position
+    if (!base || end != contentEnd || position < base || position >= windowEnd)
+        classify(position, end);
+
+    while (true) {
+
+        // rest of the block of the position
+        const std::size_t offset = static_cast<std::size_t>(position - base);
+        std::size_t block = offset / 64;
+        const std::uint64_t bits = blocks[block][bitmap] >> (offset % 64);
+        if (bits)
+            return static_cast<std::size_t>(position - content.data()) + lowestBit(bits);
+
+        // following blocks of the window
+        const std::size_t blockCount = (static_cast<std::size_t>(windowEnd - base) + 63) / 64;
+        for (++block; block < blockCount; ++block) {
+            if (blocks[block][bitmap])
+                return static_cast<std::size_t>(base + block * 64 - content.data()) + lowestBit(blocks[block][bitmap]);
+        }
+
+        // next window
+        if (windowEnd == end)
+            return std::string_view::npos;
+        position = windowEnd;
+        classify(position, end);
+    }
+}
+
+/*
+    Find the closing quote of a value
+
+    @param delimiter Quote character, '"' or '\''
+    @param content View of the content
+    @param pos Position to start the search at, after the opening quote
+    @return Position of the closing quote
+    @retval std::string_view::npos Not found
+*/
+[[nodiscard]] std::size_t StructuralIndex::findQuote(char delimiter, std::string_view content, std::size_t pos) {
+
+    // the other quote character is part of the value
+    while ((pos = find(QUOTE, content, pos)) != std::string_view::npos && content[pos] != delimiter)
+        ++pos;
+
+    return pos;
+}
+
+// forget the classified window, e.g., after the content is refilled
+void StructuralIndex::reset() {
+
+    base = nullptr;
+    windowEnd = nullptr;
+    contentEnd = nullptr;
+}
+
+/*
+    Instruction set used for classifying
+
+    @return "avx2", "sse2", or "scalar"
+*/
+[[nodiscard]] std::string_view StructuralIndex::instructionSet() {
+
+    return classifier.instructionSet;
+}
@@ -0,0 +1,137 @@
+/*
+    StructuralIndex.hpp
+
+    Include file for a two-stage structural index of the content.
+
+    Stage one classifies each 64-byte block of a window of the content at once,
+    with AVX2, SSE2, or scalar code, into bitmaps of the structural characters:
+    * character end, i.e., '<' and '&'
+    * name end, i.e., "> /\":=" and whitespace
+    * tag end, i.e., '>'
+    * quotes, i.e., '"' and '\''
+    Stage two walks the set bits of a bitmap to find the next structural
+    character, instead of a new scan of the content from each position.
+
+    Quotes are only delimiters inside a tag, and srcML characters often contain
+    quotes, e.g., string literals, so quoted regions are not masked from the
+    whole window. The parser only searches for quotes inside a tag, where it
+    finds the closing quote of an attribute value by walking the quote bitmap.
+
+    The index is for the content between refills. After the content is
+    refilled, the index must be reset.
+*/
+
+#ifndef INCLUDED_STRUCTURALINDEX_HPP
+#define INCLUDED_STRUCTURALINDEX_HPP
+
+#include <string_view>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+class StructuralIndex {
+
+    public:
+
+    // bitmaps of the structural characters
+    enum Bitmap { CHARACTER_END, NAME_END, TAG_END, QUOTE, BITMAP_COUNT };
+
+    // bitmaps of a 64-byte block
+    using BlockBitmaps = std::array<std::uint64_t, BITMAP_COUNT>;
+
+    // number of blocks in the window of the content classified at once
+    static constexpr std::size_t WINDOW_BLOCKS = 512;
+
+    /*
+        Find the next structural character of the bitmap
+
+        @param bitmap Bitmap of the structural characters
+        @param content View of the content
+        @param pos Position to start the search at
+        @return Position of the first character in the bitmap
+        @retval std::string_view::npos Not found
+    */
+    [[nodiscard]] inline std::size_t find(Bitmap bitmap, std::string_view content, std::size_t pos = 0);
+
+    /*
+        Find the closing quote of a value
+
+        @param delimiter Quote character, '"' or '\''
+        @param content View of the content
+        @param pos Position to start the search at, after the opening quote
+        @return Position of the closing quote
+        @retval std::string_view::npos Not found
+    */
+    [[nodiscard]] std::size_t findQuote(char delimiter, std::string_view content, std::size_t pos = 0);
+
+    // forget the classified window, e.g., after the content is refilled
+    void reset();
+
+    /*
+        Instruction set used for classifying
+
+        @return "avx2", "sse2", or "scalar"
+    */
+    [[nodiscard]] static std::string_view instructionSet();
+
+    private:
+
+    // position of the lowest set bit of nonzero bits
+    [[nodiscard]] static int lowestBit(std::uint64_t bits) {
+
+#if defined(_MSC_VER)
+        unsigned long position = 0;
+        _BitScanForward64(&position, bits);
+        return static_cast<int>(position);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+
+    // stage one, classify the window starting at the position up to the end of the content
+    void classify(const char* start, const char* end);
+
+    // find past the position in the window, classifying the next windows as needed
+    [[nodiscard]] std::size_t findAfterWindow(Bitmap bitmap, std::string_view content, std::size_t pos);
+
+    // start of the window, nullptr if none
+    const char* base = nullptr;
+
+    // end of the classified window
+    const char* windowEnd = nullptr;
+
+    // end of the content when the window was classified
+    const char* contentEnd = nullptr;
+
+    std::array<BlockBitmaps, WINDOW_BLOCKS> blocks;
+};
+
+/*
+    Find the next structural character of the bitmap
+
+    @param bitmap Bitmap of the structural characters
+    @param content View of the content
+    @param pos Position to start the search at
+    @return Position of the first character in the bitmap
+    @retval std::string_view::npos Not found
+*/
+[[nodiscard]] inline std::size_t StructuralIndex::find(Bitmap bitmap, std::string_view content, std::size_t pos) {
+
+    // stage two, the common case of a set bit in the rest of the block of the position
+    const char* position = content.data() + pos;
+    if (position >= base && position < windowEnd) {
+        const std::size_t offset = static_cast<std::size_t>(position - base);
+        const std::size_t block = offset / 64;
+        const std::uint64_t bits = blocks[block][bitmap] >> (offset % 64);
+        if (bits)
+            return pos + static_cast<std::size_t>(lowestBit(bits));
+    }
+
+    return findAfterWindow(bitmap, content, pos);
+}
+
+#endif
@@ -0,0 +1,144 @@
+/*
+    UnitReport.cpp
+
+    Implementation file for streaming the measures of each unit of a srcML archive
+*/
+
+#include "UnitReport.hpp"
+
+#include <string>
+#include <charconv>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // names of the measures, in the order of the columns
+    constexpr std::string_view MEASURES[] = {
+        "characters"sv, "loc"sv, "classes"sv, "functions"sv, "declarations"sv,
+        "expressions"sv, "comments"sv, "returns"sv, "line_comments"sv, "strings"sv
+    };
+
+    // append the number to the row
+    void appendNumber(std::string& row, long long value) {
+
+        char digits[24];
+        const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        row.append(digits, result.ptr);
+    }
+
+    // append the text as a CSV field, quoted only when needed
+    void appendCSVField(std::string& row, std::string_view field) {
+
+        if (field.find_first_of(",\"\r\n"sv) == std::string_view::npos) {
+            row += field;
+            return;
+        }
+        row += '"';
+        for (const char c : field) {
+            if (c == '"')
+                row += '"';
+            row += c;
+        }
+        row += '"';
+    }
+
+    // append the text as a JSON string
+    void appendJSONString(std::string& row, std::string_view field) {
+
+        row += '"';
+        for (const char c : field) {
+            if (c == '"' || c == '\\') {
+                row += '\\';
+                row += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                constexpr std::string_view HEX = "0123456789abcdef"sv;
+                row += "\\u00"sv;
+                row += HEX[static_cast<unsigned char>(c) >> 4];
+                row += HEX[static_cast<unsigned char>(c) & 0xF];
+            } else {
+                row += c;
+            }
+        }
+        row += '"';
+    }
+}
+
+/*
+    Format of a report file from its extension
+
+    @param path Path of the report file
+    @return JSON_LINES for ".jsonl" and ".json", otherwise CSV
+*/
+[[nodiscard]] UnitReport::Format UnitReport::formatOf(std::string_view path) {
+
+    const auto dot = path.rfind('.');
+    const std::string_view extension = dot == std::string_view::npos ? ""sv : path.substr(dot);
+    return extension == ".jsonl"sv || extension == ".json"sv ? Format::JSON_LINES : Format::CSV;
+}
+
+// constructor, with the CSV header written
+UnitReport::UnitReport(int fd, Format format) : format(format), output(fd) {
+
+    if (format != Format::CSV)
+        return;
+
+    std::string header("filename,language"sv);
+    for (const auto measure : MEASURES) {
+        header += ',';
+        header += measure;
+    }
+    header += '\n';
+    output.write(header);
+}
+
+/*
+    Write the row of a unit, from any thread
+
+    @param filename Filename attribute of the unit, empty if none
+    @param language Language attribute of the unit, empty if none
+    @param counts Measures of the unit
+*/
+void UnitReport::write(std::string_view filename, std::string_view language, const UnitCounts& counts) {
+
+    const long long values[] = {
+        counts.characters, counts.loc, counts.classes, counts.functions, counts.declarations,
+        counts.expressions, counts.comments, counts.returns, counts.lineComments, counts.strings
+    };
+
+    // row is formatted outside of the lock
+    std::string row;
+    if (format == Format::CSV) {
+        appendCSVField(row, filename);
+        row += ',';
+        appendCSVField(row, language);
+        for (const auto value : values) {
+            row += ',';
+            appendNumber(row, value);
+        }
+    } else {
+        row += "{\"filename\":"sv;
+        appendJSONString(row, filename);
+        row += ",\"language\":"sv;
+        appendJSONString(row, language);
+        for (std::size_t i = 0; i < std::size(values); ++i) {
+            row += ",\""sv;
+            row += MEASURES[i];
+            row += "\":"sv;
+            appendNumber(row, values[i]);
+        }
+        row += '}';
+    }
+    row += '\n';
+
+    const std::lock_guard<std::mutex> lock(mutex);
+    output.write(row);
+    ++unitCount;
+}
+
+// number of rows written
+[[nodiscard]] long long UnitReport::getUnitCount() const {
+
+    return unitCount;
+}
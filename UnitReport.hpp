@@ -0,0 +1,76 @@
+/*
+    UnitReport.hpp
+
+    Include file for streaming the measures of each unit of a srcML archive.
+
+    Each unit is a row, written as the unit ends, so the rows of a large
+    archive are not stored in memory. The rows are CSV with a header line,
+    or JSON Lines with one object for each unit. Units parsed in parallel
+    are written in the order they finish.
+*/
+
+#ifndef INCLUDED_UNITREPORT_HPP
+#define INCLUDED_UNITREPORT_HPP
+
+#include "OutputSink.hpp"
+
+#include <string_view>
+#include <mutex>
+
+// measures of a unit
+struct UnitCounts {
+    long long characters = 0;
+    long long loc = 0;
+    long long classes = 0;
+    long long functions = 0;
+    long long declarations = 0;
+    long long expressions = 0;
+    long long comments = 0;
+    long long returns = 0;
+    long long lineComments = 0;
+    long long strings = 0;
+};
+
+class UnitReport {
+
+    public:
+
+    // format of the rows
+    enum class Format { CSV, JSON_LINES };
+
+    /*
+        Format of a report file from its extension
+
+        @param path Path of the report file
+        @return JSON_LINES for ".jsonl" and ".json", otherwise CSV
+    */
+    [[nodiscard]] static Format formatOf(std::string_view path);
+
+    // constructor, with the CSV header written
+    UnitReport(int fd, Format format);
+
+    UnitReport(const UnitReport&) = delete;
+
+    UnitReport& operator=(const UnitReport&) = delete;
+
+    /*
+        Write the row of a unit, from any thread
+
+        @param filename Filename attribute of the unit, empty if none
+        @param language Language attribute of the unit, empty if none
+        @param counts Measures of the unit
+    */
+    void write(std::string_view filename, std::string_view language, const UnitCounts& counts);
+
+    // number of rows written
+    [[nodiscard]] long long getUnitCount() const;
+
+    private:
+
+    Format format;
+    long long unitCount = 0;
+    std::mutex mutex;
+    OutputSink output;
+};
+
+#endif
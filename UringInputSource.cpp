@@ -0,0 +1,402 @@
+/*
+    UringInputSource.cpp
+
+    Implementation file for an input source that reads a regular file with io_uring
+*/
+
+#include "UringInputSource.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+
+#if defined(__linux__) && defined(__has_include) && !defined(NO_IO_URING)
+#if __has_include(<linux/io_uring.h>)
+#define HAVE_IO_URING
+#endif
+#endif
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    const std::size_t READ_BLOCK_SIZE = 4096;
+
+#ifdef HAVE_IO_URING
+    int ioUringSetup(unsigned entries, io_uring_params* params) {
+
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int ioUringEnter(int ringFD, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+
+        return static_cast<int>(syscall(__NR_io_uring_enter, ringFD, toSubmit, minComplete, flags, nullptr, 0));
+    }
+
+    int ioUringRegister(int ringFD, unsigned opcode, const void* arg, unsigned count) {
+
+        return static_cast<int>(syscall(__NR_io_uring_register, ringFD, opcode, arg, count));
+    }
+
+    // field of a mapped ring at the offset
+    template <typename T>
+    T* ringField(void* ring, std::uint32_t offset) {
+
+        return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+    }
+#endif
+}
+
+/*
+    Ring for the current thread, shared by its input sources when not in use
+
+    @param bufferSize Size of each read, and of the headroom for unprocessed content
+    @return Ring
+    @retval nullptr io_uring is not available
+*/
+[[nodiscard]] std::shared_ptr<IOUring> IOUring::shared(std::size_t bufferSize) {
+
+    thread_local std::shared_ptr<IOUring> ring;
+    thread_local bool unavailable = false;
+    if (unavailable)
+        return nullptr;
+
+    // a ring in use, e.g., by an open input source, is not shared
+    if (ring && ring->inUse)
+        return create(bufferSize);
+
+    if (!ring) {
+        ring = create(bufferSize);
+        unavailable = !ring;
+    }
+
+    return ring;
+}
+
+/*
+    New ring
+
+    @param bufferSize Size of each read, and of the headroom for unprocessed content
+    @param slotCount Number of slots, i.e., reads kept queued
+    @return Ring
+    @retval nullptr io_uring is not available
+*/
+[[nodiscard]] std::shared_ptr<IOUring> IOUring::create(std::size_t bufferSize, std::size_t slotCount) {
+
+#ifdef HAVE_IO_URING
+    std::shared_ptr<IOUring> ring(new IOUring());
+
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ring->ringFD = ioUringSetup(static_cast<unsigned>(slotCount), &params);
+    if (ring->ringFD == -1)
+        return nullptr;
+
+    // map the submission queue, completion queue, and submission entries
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        ring->sqRingSize = ring->cqRingSize = std::max(ring->sqRingSize, ring->cqRingSize);
+    ring->sqRing = mmap(nullptr, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ringFD, IORING_OFF_SQ_RING);
+    if (ring->sqRing == MAP_FAILED) {
+        ring->sqRing = nullptr;
+        return nullptr;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cqRing = ring->sqRing;
+    } else {
+        ring->cqRing = mmap(nullptr, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ringFD, IORING_OFF_CQ_RING);
+        if (ring->cqRing == MAP_FAILED) {
+            ring->cqRing = nullptr;
+            return nullptr;
+        }
+    }
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqes = mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ringFD, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        ring->sqes = nullptr;
+        return nullptr;
+    }
+    ring->sqTail = ringField<unsigned>(ring->sqRing, params.sq_off.tail);
+    ring->sqMask = ringField<unsigned>(ring->sqRing, params.sq_off.ring_mask);
+    ring->sqArray = ringField<unsigned>(ring->sqRing, params.sq_off.array);
+    ring->cqHead = ringField<unsigned>(ring->cqRing, params.cq_off.head);
+    ring->cqTail = ringField<unsigned>(ring->cqRing, params.cq_off.tail);
+    ring->cqMask = ringField<unsigned>(ring->cqRing, params.cq_off.ring_mask);
+    ring->cqes = ringField<io_uring_cqe>(ring->cqRing, params.cq_off.cqes);
+
+    // slots with headroom, data read in whole blocks, and a block of zeros for lookahead
+    ring->slotReadSize = std::max(READ_BLOCK_SIZE, bufferSize - bufferSize % READ_BLOCK_SIZE);
+    ring->slotHeadroom = ring->slotReadSize;
+    std::vector<iovec> iovecs;
+    for (std::size_t i = 0; i < slotCount; ++i) {
+        ring->slots.emplace_back(new char[ring->slotHeadroom + ring->slotReadSize + READ_BLOCK_SIZE]());
+        iovecs.push_back({ ring->slotData(i), ring->slotReadSize });
+    }
+
+    // registered buffers avoid mapping the pages for each read, but count
+    // against the locked memory limit, so plain reads are used without them
+    ring->registered = ioUringRegister(ring->ringFD, IORING_REGISTER_BUFFERS, iovecs.data(), static_cast<unsigned>(iovecs.size())) == 0;
+
+    return ring;
+#else
+    return nullptr;
+#endif
+}
+
+// destructor
+IOUring::~IOUring() {
+
+#ifdef HAVE_IO_URING
+    if (sqes)
+        munmap(sqes, sqesSize);
+    if (cqRing && cqRing != sqRing)
+        munmap(cqRing, cqRingSize);
+    if (sqRing)
+        munmap(sqRing, sqRingSize);
+    if (ringFD != -1)
+        close(ringFD);
+#endif
+}
+
+// number of slots
+[[nodiscard]] std::size_t IOUring::slotCount() const {
+
+    return slots.size();
+}
+
+// size of the data of each slot
+[[nodiscard]] std::size_t IOUring::readSize() const {
+
+    return slotReadSize;
+}
+
+// size of the headroom before the data of each slot
+[[nodiscard]] std::size_t IOUring::headroom() const {
+
+    return slotHeadroom;
+}
+
+// start of the data of the slot
+[[nodiscard]] char* IOUring::slotData(std::size_t slot) const {
+
+    return slots[slot].get() + slotHeadroom;
+}
+
+// queue a read of the file into the slot, submitted with the next submit() or wait()
+void IOUring::queueRead(std::size_t slot, int fd, std::uint64_t offset, std::size_t size) {
+
+#ifdef HAVE_IO_URING
+    // only this thread produces submissions, so the tail is read without ordering
+    const unsigned tail = *sqTail;
+    const unsigned index = tail & *sqMask;
+    io_uring_sqe& sqe = static_cast<io_uring_sqe*>(sqes)[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = registered ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    sqe.fd = fd;
+    sqe.off = offset;
+    sqe.addr = reinterpret_cast<std::uint64_t>(slotData(slot));
+    sqe.len = static_cast<std::uint32_t>(size);
+    sqe.buf_index = static_cast<std::uint16_t>(slot);
+    sqe.user_data = slot;
+    sqArray[index] = index;
+    __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    ++toSubmit;
+#endif
+}
+
+// submit the queued reads
+[[nodiscard]] bool IOUring::submit() {
+
+#ifdef HAVE_IO_URING
+    while (toSubmit > 0) {
+        const int submitted = ioUringEnter(ringFD, toSubmit, 0, 0);
+        if (submitted == -1) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        toSubmit -= static_cast<unsigned>(submitted);
+    }
+#endif
+    return true;
+}
+
+/*
+    Wait for a read to complete, submitting any queued reads
+
+    @param[out] slot Slot of the completed read
+    @param[out] result Bytes read, or negative errno
+    @return If a completion was received
+*/
+[[nodiscard]] bool IOUring::wait(std::size_t& slot, long& result) {
+
+#ifdef HAVE_IO_URING
+    while (true) {
+
+        // only this thread consumes completions, so the head is read without ordering
+        const unsigned head = *cqHead;
+        if (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+            const io_uring_cqe& cqe = static_cast<io_uring_cqe*>(cqes)[head & *cqMask];
+            slot = static_cast<std::size_t>(cqe.user_data);
+            result = cqe.res;
+            __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+
+        // submit and wait in one system call
+        const int submitted = ioUringEnter(ringFD, toSubmit, 1, IORING_ENTER_GETEVENTS);
+        if (submitted == -1) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        toSubmit -= static_cast<unsigned>(submitted);
+    }
+#else
+    return false;
+#endif
+}
+
+// constructor, queueing the first reads
+UringInputSource::UringInputSource(std::shared_ptr<IOUring> ring, int fd, bool ownsFD)
+    : ring(std::move(ring)), fd(fd), ownsFD(ownsFD), fileSize(0), nextOffset(0), reads(this->ring->slotCount()) {
+
+    this->ring->inUse = true;
+
+#ifdef HAVE_IO_URING
+    // respect any input already consumed from the file
+    struct stat st;
+    if (fstat(fd, &st) == 0)
+        fileSize = static_cast<std::uint64_t>(st.st_size);
+    const off_t offset = lseek(fd, 0, SEEK_CUR);
+    nextOffset = offset == -1 ? 0 : static_cast<std::uint64_t>(offset);
+#endif
+
+    for (std::size_t slot = 0; slot < reads.size(); ++slot)
+        queueNext(slot);
+    if (!this->ring->submit())
+        done = true;
+}
+
+// destructor, waiting for the queued reads before the ring is reused
+UringInputSource::~UringInputSource() {
+
+    for (std::size_t slot = 0; slot < reads.size(); ++slot) {
+        if (reads[slot].queued && !waitFor(slot))
+            break;
+    }
+    ring->inUse = false;
+
+#ifdef HAVE_IO_URING
+    if (ownsFD)
+        close(fd);
+#endif
+}
+
+// queue the read of the next part of the file into the slot
+void UringInputSource::queueNext(std::size_t slot) {
+
+    reads[slot] = SlotRead();
+    if (nextOffset >= fileSize)
+        return;
+
+    reads[slot].offset = nextOffset;
+    reads[slot].queued = true;
+    ring->queueRead(slot, fd, nextOffset, ring->readSize());
+    nextOffset += ring->readSize();
+}
+
+// wait for the read of the slot to complete
+[[nodiscard]] bool UringInputSource::waitFor(std::size_t slot) {
+
+    while (!reads[slot].complete) {
+        std::size_t completedSlot = 0;
+        long result = 0;
+        if (!ring->wait(completedSlot, result))
+            return false;
+        reads[completedSlot].result = result;
+        reads[completedSlot].complete = true;
+    }
+    reads[slot].queued = false;
+
+    return true;
+}
+
+/*
+    Refill the content preserving the existing data.
+
+    The unprocessed content is copied into the headroom of the next slot,
+    directly before its data, and the current slot is queued for the next
+    part of the file.
+
+    @param[in, out] content View of the content
+    @return Number of bytes read
+    @retval 0 EOF
+    @retval -1 Read error, or the unprocessed content does not fit the headroom
+*/
+[[nodiscard]] long UringInputSource::refill(std::string_view& content) {
+
+    if (done)
+        return 0;
+
+    if (content.size() > ring->headroom())
+        return -1;
+
+    // slots are read in order
+    const std::size_t next = hasSlot ? (current + 1) % reads.size() : 0;
+    if (!reads[next].queued) {
+        done = true;
+        return 0;
+    }
+    if (!waitFor(next) || reads[next].result < 0)
+        return -1;
+
+    // a short read before the end of the file is completed with reads
+    long bytesRead = reads[next].result;
+    char* data = ring->slotData(next);
+#ifdef HAVE_IO_URING
+    while (bytesRead > 0 && static_cast<std::size_t>(bytesRead) < ring->readSize() && reads[next].offset + bytesRead < fileSize) {
+        const ssize_t rest = pread(fd, data + bytesRead, ring->readSize() - bytesRead, static_cast<off_t>(reads[next].offset + bytesRead));
+        if (rest == -1 && errno == EINTR)
+            continue;
+        if (rest <= 0)
+            break;
+        bytesRead += static_cast<long>(rest);
+    }
+#endif
+    if (bytesRead == 0) {
+        done = true;
+        return 0;
+    }
+
+    // preserve the unprocessed content directly before the new data
+    std::copy(content.cbegin(), content.cend(), data - content.size());
+    content = std::string_view(data - content.size(), content.size() + bytesRead);
+
+    // reuse the current slot for the next part of the file
+    if (hasSlot) {
+        queueNext(current);
+        if (!ring->submit())
+            return -1;
+    }
+    current = next;
+    hasSlot = true;
+
+    return bytesRead;
+}
+
+// name of the input mode
+[[nodiscard]] std::string_view UringInputSource::mode() const {
+
+    return "io_uring"sv;
+}
@@ -0,0 +1,166 @@
+/*
+    UringInputSource.hpp
+
+    Include file for an input source that reads a regular file with io_uring.
+
+    Several large reads are kept queued against the file, each into a slot
+    of buffers registered with the ring, so the device sees a queue depth
+    instead of one read at a time, and a refill usually finds its data
+    already read without a system call. A ring can be shared by the input
+    sources of a thread, one after another, e.g., when parsing many files.
+
+    io_uring is used through its system calls, so there is no library
+    dependency. Without io_uring, e.g., an older kernel, a sandbox, or
+    a build without it, no ring is available and callers fall back to read().
+*/
+
+#ifndef INCLUDED_URINGINPUTSOURCE_HPP
+#define INCLUDED_URINGINPUTSOURCE_HPP
+
+#include "InputSource.hpp"
+#include <vector>
+#include <cstdint>
+
+// ring with registered buffers, used by one input source at a time
+class IOUring {
+
+    public:
+
+    /*
+        Ring for the current thread, shared by its input sources when not in use
+
+        @param bufferSize Size of each read, and of the headroom for unprocessed content
+        @return Ring
+        @retval nullptr io_uring is not available
+    */
+    [[nodiscard]] static std::shared_ptr<IOUring> shared(std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+    /*
+        New ring
+
+        @param bufferSize Size of each read, and of the headroom for unprocessed content
+        @param slotCount Number of slots, i.e., reads kept queued
+        @return Ring
+        @retval nullptr io_uring is not available
+    */
+    [[nodiscard]] static std::shared_ptr<IOUring> create(std::size_t bufferSize = DEFAULT_BUFFER_SIZE, std::size_t slotCount = 4);
+
+    IOUring(const IOUring&) = delete;
+
+    IOUring& operator=(const IOUring&) = delete;
+
+    ~IOUring();
+
+    // number of slots
+    [[nodiscard]] std::size_t slotCount() const;
+
+    // size of the data of each slot
+    [[nodiscard]] std::size_t readSize() const;
+
+    // size of the headroom before the data of each slot
+    [[nodiscard]] std::size_t headroom() const;
+
+    // start of the data of the slot
+    [[nodiscard]] char* slotData(std::size_t slot) const;
+
+    // queue a read of the file into the slot, submitted with the next submit() or wait()
+    void queueRead(std::size_t slot, int fd, std::uint64_t offset, std::size_t size);
+
+    // submit the queued reads
+    [[nodiscard]] bool submit();
+
+    /*
+        Wait for a read to complete, submitting any queued reads
+
+        @param[out] slot Slot of the completed read
+        @param[out] result Bytes read, or negative errno
+        @return If a completion was received
+    */
+    [[nodiscard]] bool wait(std::size_t& slot, long& result);
+
+    // ring is used by an input source
+    bool inUse = false;
+
+    private:
+
+    IOUring() = default;
+
+    int ringFD = -1;
+    bool registered = false;
+    unsigned toSubmit = 0;
+
+    // mapped rings
+    void* sqRing = nullptr;
+    std::size_t sqRingSize = 0;
+    void* cqRing = nullptr;
+    std::size_t cqRingSize = 0;
+    void* sqes = nullptr;
+    std::size_t sqesSize = 0;
+
+    // fields of the rings
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    void* cqes = nullptr;
+
+    // slot buffers
+    std::size_t slotReadSize = 0;
+    std::size_t slotHeadroom = 0;
+    std::vector<std::unique_ptr<char[]>> slots;
+};
+
+class UringInputSource : public InputSource {
+
+    private:
+
+    // state of the read of a slot
+    struct SlotRead {
+        std::uint64_t offset = 0;
+        long result = 0;
+        bool queued = false;
+        bool complete = false;
+    };
+
+    std::shared_ptr<IOUring> ring;
+    int fd;
+    bool ownsFD;
+    std::uint64_t fileSize;
+    std::uint64_t nextOffset;
+    std::vector<SlotRead> reads;
+    std::size_t current = 0;
+    bool hasSlot = false;
+    bool done = false;
+
+    // queue the read of the next part of the file into the slot
+    void queueNext(std::size_t slot);
+
+    // wait for the read of the slot to complete
+    [[nodiscard]] bool waitFor(std::size_t slot);
+
+    public:
+
+    /*
+        Constructor, queueing the first reads
+
+        @param ring Ring for the reads, not in use by another input source
+        @param fd File descriptor of a regular file
+        @param ownsFD Close the file descriptor in the destructor
+    */
+    UringInputSource(std::shared_ptr<IOUring> ring, int fd, bool ownsFD = false);
+
+    UringInputSource(const UringInputSource&) = delete;
+
+    UringInputSource& operator=(const UringInputSource&) = delete;
+
+    // destructor, waiting for the queued reads before the ring is reused
+    ~UringInputSource() override;
+
+    [[nodiscard]] long refill(std::string_view& content) override;
+
+    [[nodiscard]] std::string_view mode() const override;
+};
+
+#endif
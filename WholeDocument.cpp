@@ -0,0 +1,62 @@
+/*
+    WholeDocument.cpp
+
+    Implementation file for an entire document in memory
+*/
+
+#include "WholeDocument.hpp"
+#include "MemoryInputSource.hpp"
+#include "DecompressInputSource.hpp"
+
+#include <memory>
+#include <string>
+
+// constructor, with the entire input of fd from its current offset
+WholeDocument::WholeDocument(int fd) : mapped(fd) {
+
+    document = mapped.view();
+    if (mapped.isMapped() && detectCompression(document) == Compression::NONE) {
+        modeName = "mmap";
+        loaded = true;
+        return;
+    }
+
+    // compressed or unmapped input is read into the buffer, decompressed
+    auto input = mapped.isMapped() ? std::make_unique<DecompressInputSource>(std::make_unique<MemoryInputSource>(document))
+                                   : makeInputSource(fd, DEFAULT_BUFFER_SIZE, InputMode::READ);
+    std::string_view content;
+    long bytesRead = 0;
+    while ((bytesRead = input->refill(content)) > 0) {
+        buffer.append(content);
+        content = std::string_view();
+    }
+    document = buffer;
+    modeName = input->mode();
+    loaded = bytesRead == 0;
+    if (!loaded)
+        errorMessage = input->error().empty() ? std::string("parser error : File input error") : "input error : " + std::string(input->error());
+}
+
+// check if the entire input is loaded
+[[nodiscard]] bool WholeDocument::isLoaded() const {
+
+    return loaded;
+}
+
+// view of the entire document
+[[nodiscard]] std::string_view WholeDocument::view() const {
+
+    return document;
+}
+
+// name of the input mode
+[[nodiscard]] std::string_view WholeDocument::mode() const {
+
+    return modeName;
+}
+
+// message of the input error when not loaded
+[[nodiscard]] std::string_view WholeDocument::error() const {
+
+    return errorMessage;
+}
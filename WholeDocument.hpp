@@ -0,0 +1,51 @@
+/*
+    WholeDocument.hpp
+
+    Include file for an entire document in memory, e.g., to split for a parallel parse.
+
+    An uncompressed regular file is memory mapped. Other input, i.e., compressed
+    input or a pipe, is read and decompressed into a buffer.
+*/
+
+#ifndef INCLUDED_WHOLEDOCUMENT_HPP
+#define INCLUDED_WHOLEDOCUMENT_HPP
+
+#include "MMapInputSource.hpp"
+
+#include <string>
+#include <string_view>
+
+class WholeDocument {
+
+    private:
+
+    MMapInputSource mapped;
+    std::string buffer;
+    std::string_view document;
+    std::string modeName;
+    std::string errorMessage;
+    bool loaded = false;
+
+    public:
+
+    // constructor, with the entire input of fd from its current offset
+    explicit WholeDocument(int fd);
+
+    WholeDocument(const WholeDocument&) = delete;
+
+    WholeDocument& operator=(const WholeDocument&) = delete;
+
+    // check if the entire input is loaded, i.e., no input error
+    [[nodiscard]] bool isLoaded() const;
+
+    // view of the entire document, followed by a null character
+    [[nodiscard]] std::string_view view() const;
+
+    // name of the input mode, e.g., "mmap"
+    [[nodiscard]] std::string_view mode() const;
+
+    // message of the input error when not loaded, e.g., for invalid compressed input
+    [[nodiscard]] std::string_view error() const;
+};
+
+#endif
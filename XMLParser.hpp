@@ -10,18 +10,107 @@
 #include <string_view>
 #include <functional>
 #include <optional>
+#include <bitset>
+#include <string>
 
 #include "XMLParserHandler.hpp"
+#include "InputSource.hpp"
+#include "NameTable.hpp"
+#include "StructuralIndex.hpp"
+#ifdef INSTRUMENT
+#include "Instrumentation.hpp"
+#endif
+
+// how the parser finds the structural characters of the content, either with a scan
+// from each position, or by walking a structural index of blocks classified at once
+enum class Tokenizer { SCAN, INDEX };
+
+// kind of error in the XML or its input
+enum class XMLErrorCode {
+    NONE, INPUT, EMPTY_FILE, DECLARATION, DOCTYPE, COMMENT, CDATA, PROCESSING_INSTRUCTION,
+    START_TAG_NAME, UNTERMINATED_START_TAG, END_TAG_NAME, UNTERMINATED_END_TAG,
+    NAMESPACE, ATTRIBUTE, CONTENT, EXTRA_CONTENT
+};
+
+// error in the XML or its input, with no error for a successful parse
+struct XMLParseError {
+
+    XMLErrorCode code = XMLErrorCode::NONE;
+
+    // byte offset in the document where the error is found
+    long long offset = 0;
+
+    // event of the token with the error, e.g., XMLParserHandler::START_TAG, 0 for none
+    unsigned int tokenKind = 0;
+
+    // message for the user, e.g., "parser error : Empty file"
+    std::string message;
+
+    // if there is an error
+    explicit operator bool() const { return code != XMLErrorCode::NONE; }
+};
+
+/*
+    XML parser that calls the handler methods for each part of the XML.
 
-class XMLParser {
+    With the XMLParserHandler as the Handler, handler methods are virtual calls.
+    With a concrete handler class as the Handler, e.g., BasicXMLParser<srcFactsParser>,
+    handler methods are called directly, and events for handler methods the class
+    does not declare are compiled away. The implementation is in XMLParserImpl.hpp.
+*/
+template <typename Handler>
+class BasicXMLParser {
     
     private: 
 
+    static constexpr int BLOCK_SIZE = 4096;
+    static constexpr std::string_view WHITESPACE = " \n\t\r";
+    static inline const std::bitset<128> xmlNameMask{"00000111111111111111111111111110100001111111111111111111111111100000001111111111011000000000000000000000000000000000000000000000"};
+
     std::string_view content;
-    long totalBytes;
+    long long totalBytes;
     bool doneReading;
     int depth;
-    XMLParserHandler& handler;
+    Handler& handler;
+    InputSource& input;
+
+    // interned names of tags and attributes
+    NameTable names;
+
+    // events the handler consumes, both subscribed to and declared
+    unsigned int events;
+
+    // start of the current run of raw tokens, nullptr if none
+    const char* rawStart = nullptr;
+
+    // handler returned SKIP for the current start tag
+    bool skipRequested = false;
+
+    // events for handleBatch(), allocated only for a handler that subscribes to BATCH
+    std::unique_ptr<EventBatch> batch;
+
+    // structural index of the content, allocated only for the INDEX tokenizer
+    std::unique_ptr<StructuralIndex> index;
+
+#ifdef INSTRUMENT
+    // counts and ticks of the parse, reported at the end of the document, or added to the total of the fragments
+    Instrumentation instrumentation;
+#endif
+
+    // events the handler declares handler methods for
+    static constexpr unsigned int declaredEvents();
+
+    // find the end of character content, i.e., the first '<' or '&', with the tokenizer
+    std::size_t characterEnd(std::size_t pos = 0);
+
+    // find the end of a name, i.e., the first of "> /\":=" or whitespace, with the tokenizer
+    std::size_t nameEnd(std::size_t pos = 0);
+
+    // find the end of a tag, i.e., the first '>', with the tokenizer
+    std::size_t tagEnd();
+
+    // find the closing quote of a value, with the tokenizer
+    std::size_t quoteEnd(char delimiter, std::size_t pos);
 
     // check if declaration
     bool isXMLDeclaration();
@@ -86,28 +175,85 @@ class XMLParser {
     // parse end tag
     void parseEndTag();
 
-    // parse start tag
-    void parseStartTag();
+    // parse start tag, returning the qualified name
+    std::string_view parseStartTag();
+
+    // end of an empty element, i.e., "/>", as an end tag
+    void endEmptyElement(std::string_view qName);
+
+    // skip the content of an element up to its end tag, with only the bytes and newlines reported
+    void skipElementContent();
 
     // parse XML namespace
     void parseXMLNamespace();
 
+    // bind the namespace declarations of the rest of the start tag without consuming it
+    void bindStartTagNamespaces();
+
     // parse attribute
     void parseAttribute();
 
+    // skip attribute or namespace
+    void skipAttribute();
+
+    // skip end tag
+    void skipEndTag();
+
+    // start or end a run of raw tokens for a token with the events
+    void rawToken(unsigned int tokenEvents);
+
+    // report the current run of raw tokens
+    void flushRaw();
+
+    // events are reported in batches
+    bool isBatching() const;
+
+    // add an event to the batch, reporting the batch when full
+    void batchEvent(XMLParserHandler::Event kind, int nameID, std::string_view text);
+
+    // report the current batch of events
+    void flushBatch();
+
     // End tracing document
     void endTracing();
 
+    // parse content, with a fragment continuing after the end of the first element
+    void parseContent(bool isFragment);
+
+    // parse the document
+    void parseDocument();
+
+    // stop the parse with the error, with the message made from the parts
+    template <typename... Parts>
+    [[noreturn]] void parseError(XMLErrorCode code, const Parts&... parts);
+
+    // stop the parse with an input error, with the message of the input source when it has one
+    [[noreturn]] void inputError();
+
     public:
 
     // constructor
-    XMLParser(XMLParserHandler& handler);
+    BasicXMLParser(Handler& handler, InputSource& input, Tokenizer tokenizer = Tokenizer::SCAN);
 
-    virtual ~XMLParser() = default;
+    virtual ~BasicXMLParser() = default;
     
-    long getTotalBytes();
+    long long getTotalBytes();
 
-    void parse();
+    // parse the document, with the error in the XML or its input, if any
+    XMLParseError parse();
+
+    // parse a fragment of element content, e.g., a sequence of elements, with the error, if any
+    XMLParseError parseFragment();
+
+    // namespace declared outside of the input, e.g., on the root of an archive for a unit fragment
+    void bindNamespace(std::string_view prefix, std::string_view uri);
 
 };
+
+// XML parser with virtual calls to the XMLParserHandler
+using XMLParser = BasicXMLParser<XMLParserHandler>;
+
+// instantiated in XMLParser.cpp
+extern template class BasicXMLParser<XMLParserHandler>;
+
 #endif
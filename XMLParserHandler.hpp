@@ -10,20 +10,60 @@
 #include <string_view>
 #include <optional>
 
+#include "EventBatch.hpp"
+
 class XMLParserHandler {
     public:
 
+    // Events of the parser, combined into the mask of events a handler consumes
+    enum Event : unsigned int {
+        START_DOCUMENT                  = 1U << 0,
+        DECLARATION                     = 1U << 1,
+        DOCTYPE                         = 1U << 2,
+        START_TAG                       = 1U << 3,
+        END_TAG                         = 1U << 4,
+        ATTRIBUTE                       = 1U << 5,
+        NAMESPACE                       = 1U << 6,
+        COMMENT                         = 1U << 7,
+        CDATA                           = 1U << 8,
+        PROCESSING_INSTRUCTION          = 1U << 9,
+        CHARACTER_ENTITY_REFERENCES     = 1U << 10,
+        CHARACTER_NON_ENTITY_REFERENCES = 1U << 11,
+        END_DOCUMENT                    = 1U << 12,
+        SKIPPED                         = 1U << 15,
+        ALL_EVENTS                      = ((1U << 13) - 1) | SKIPPED,
+        RAW                             = 1U << 13,
+        BATCH                           = 1U << 14,
+
+        // events reported in batches with BATCH
+        BATCHED_EVENTS = START_TAG | END_TAG | ATTRIBUTE | COMMENT | CDATA | CHARACTER_ENTITY_REFERENCES | CHARACTER_NON_ENTITY_REFERENCES
+    };
+
+    // What the parser does after a start tag. With SKIP, the parser fast-forwards past
+    // the content of the element without events, and reports only the bytes and
+    // newlines of the content. The attributes and the end tag of the element are reported.
+    enum Directive { CONTINUE, SKIP };
+
+    // Events the handler consumes, queried once by the parser.
+    // Attributes, namespaces, and end tags that are not consumed are skipped
+    // without splitting names or computing values.
+    // With RAW, tokens of the other events are reported as raw source spans.
+    // With BATCH, the subscribed BATCHED_EVENTS are reported in batches to handleBatch(),
+    // so start tags in a batch cannot skip.
+    virtual unsigned int events() const { return ALL_EVENTS; }
+
     virtual void handleStartDocument() {};
 
     virtual void handleDeclaration(std::string_view version, std::optional<std::string_view> encoding, std::optional<std::string_view> standalone) {};
 
     virtual void handleDOCTYPE() {};
 
-    virtual void handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) {};
+    // The nameID of tags and attributes is the ID of the name in the NameTable of the parser
+    virtual Directive handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) { return CONTINUE; };
 
-    virtual void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) {};
+    virtual void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) {};
 
-    virtual void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) {};
+    virtual void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value, int nameID) {};
 
     virtual void handleNamespace(std::string_view prefix, std::string_view uri) {};
 
@@ -38,6 +78,17 @@ class XMLParserHandler {
     virtual void handleCharacterNonEntityReferences(std::string_view characters) {};
 
     virtual void handleEndDocument() {};
+
+    // Bytes and newlines of the content of an element skipped after its start tag
+    virtual void handleSkipped(long long bytes, long long newlines) {};
+
+    // Source text of a run of tokens whose events the handler does not subscribe to,
+    // valid only during the call
+    virtual void handleRaw(std::string_view raw) {};
+
+    // Batch of events, reported before each refill of the content, before an event
+    // that is not batched, and at the end of the document, valid only during the call
+    virtual void handleBatch(const EventBatch& batch) {};
 };
 
 #endif
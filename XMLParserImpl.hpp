@@ -0,0 +1,1268 @@
+/*
+    XMLParserImpl.hpp
+
+    Implementation of the xml parser functions of BasicXMLParser.
+    Included where the parser is instantiated for a handler type.
+*/
+
+#ifndef INCLUDED_XMLPARSERIMPL_HPP
+#define INCLUDED_XMLPARSERIMPL_HPP
+
+#include "XMLParser.hpp"
+#include "scanCharacters.hpp"
+#include <iostream>
+#include <bitset>
+#include <optional>
+#include <cassert>
+#include <algorithm>
+#include <iomanip>
+#include <type_traits>
+#include <utility>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+// trace parsing
+#ifdef TRACE
+#undef TRACE
+#define HEADER(m) std::clog << "\033[1m" << std::setw(10) << std::left << m << "\u001b[0m" << '\t'
+#define TRACE0() ""
+#define TRACE1(l1, n1)                         "\033[1m" << l1 << "\u001b[0m" << "|" << "\u001b[31;1m" << n1 << "\u001b[0m" << "| "
+#define TRACE2(l1, n1, l2, n2)                 TRACE1(l1,n1)             << TRACE1(l2,n2)
+#define TRACE3(l1, n1, l2, n2, l3, n3)         TRACE2(l1,n1,l2,n2)       << TRACE1(l3,n3)
+#define TRACE4(l1, n1, l2, n2, l3, n3, l4, n4) TRACE3(l1,n1,l2,n2,l3,n3) << TRACE1(l4,n4)
+#define GET_TRACE(_2,_3,_4,_5,_6,_7,_8,_9,NAME,...) NAME
+#define TRACE(m,...) HEADER(m) << GET_TRACE(__VA_ARGS__, TRACE4, _UNUSED, TRACE3, _UNUSED, TRACE2, _UNUSED, TRACE1, TRACE0, TRACE0)(__VA_ARGS__) << '\n';
+#else
+#define TRACE(...)
+#endif
+
+// instrumentation of the parse, with statements only compiled with INSTRUMENT
+#ifdef INSTRUMENT
+#define INSTRUMENTED(...) __VA_ARGS__
+#define INSTRUMENT_HANDLER(event, call) do { \
+            const Instrumentation::Ticks handlerStart = instrumentation.startHandler(); \
+            call; \
+            instrumentation.endHandler(XMLParserHandler::event, handlerStart); \
+        } while (false)
+#else
+#define INSTRUMENTED(...)
+#define INSTRUMENT_HANDLER(event, call) call
+#endif
+
+// check if the handler consumes the event, i.e., is the virtual XMLParserHandler or declares the handler method,
+// so that calls for events a static handler does not declare are compiled away
+#define HANDLES(method) (std::is_same_v<Handler, XMLParserHandler> || !std::is_same_v<decltype(&Handler::method), decltype(&XMLParserHandler::method)>)
+
+// check if the handler subscribed to the event
+#define SUBSCRIBED(event) (events & XMLParserHandler::event)
+
+// events the handler declares handler methods for
+template <typename Handler>
+constexpr unsigned int BasicXMLParser<Handler>::declaredEvents() {
+
+    return (HANDLES(handleStartDocument)                ? XMLParserHandler::START_DOCUMENT : 0U)
+         | (HANDLES(handleDeclaration)                  ? XMLParserHandler::DECLARATION : 0U)
+         | (HANDLES(handleDOCTYPE)                      ? XMLParserHandler::DOCTYPE : 0U)
+         | (HANDLES(handleStartTag)                     ? XMLParserHandler::START_TAG : 0U)
+         | (HANDLES(handleEndTag)                       ? XMLParserHandler::END_TAG : 0U)
+         | (HANDLES(handleAttribute)                    ? XMLParserHandler::ATTRIBUTE : 0U)
+         | (HANDLES(handleNamespace)                    ? XMLParserHandler::NAMESPACE : 0U)
+         | (HANDLES(handleComment)                      ? XMLParserHandler::COMMENT : 0U)
+         | (HANDLES(handleCDATA)                        ? XMLParserHandler::CDATA : 0U)
+         | (HANDLES(handleProcessingInstruction)        ? XMLParserHandler::PROCESSING_INSTRUCTION : 0U)
+         | (HANDLES(handleCharacterEntityReferences)    ? XMLParserHandler::CHARACTER_ENTITY_REFERENCES : 0U)
+         | (HANDLES(handleCharacterNonEntityReferences) ? XMLParserHandler::CHARACTER_NON_ENTITY_REFERENCES : 0U)
+         | (HANDLES(handleEndDocument)                  ? XMLParserHandler::END_DOCUMENT : 0U)
+         | (HANDLES(handleSkipped)                      ? XMLParserHandler::SKIPPED : 0U)
+         | (HANDLES(handleRaw)                          ? XMLParserHandler::RAW : 0U)
+         | (HANDLES(handleBatch)                        ? XMLParserHandler::BATCH | XMLParserHandler::BATCHED_EVENTS : 0U);
+}
+
+// constructor
+template <typename Handler>
+BasicXMLParser<Handler>::BasicXMLParser(Handler& handler, InputSource& input, Tokenizer tokenizer)
+   : handler(handler), input(input) {
+   totalBytes = 0;
+   doneReading = false;
+   depth = 0;
+   events = handler.events() & declaredEvents();
+   if (isBatching())
+       batch = std::make_unique<EventBatch>();
+   if (tokenizer == Tokenizer::INDEX)
+       index = std::make_unique<StructuralIndex>();
+}
+
+// find the end of character content, i.e., the first '<' or '&', with the tokenizer
+template <typename Handler>
+inline std::size_t BasicXMLParser<Handler>::characterEnd(std::size_t pos) {
+
+    return index ? index->find(StructuralIndex::CHARACTER_END, content, pos) : findCharacterEnd(content, pos);
+}
+
+// find the end of a name, i.e., the first of "> /\":=" or whitespace, with the tokenizer
+template <typename Handler>
+inline std::size_t BasicXMLParser<Handler>::nameEnd(std::size_t pos) {
+
+    return index ? index->find(StructuralIndex::NAME_END, content, pos) : findNameEnd(content, pos);
+}
+
+// find the end of a tag, i.e., the first '>', with the tokenizer
+template <typename Handler>
+inline std::size_t BasicXMLParser<Handler>::tagEnd() {
+
+    return index ? index->find(StructuralIndex::TAG_END, content) : content.find('>');
+}
+
+// find the closing quote of a value, with the tokenizer
+template <typename Handler>
+inline std::size_t BasicXMLParser<Handler>::quoteEnd(char delimiter, std::size_t pos) {
+
+    return index ? index->findQuote(delimiter, content, pos) : content.find(delimiter, pos);
+}
+
+// Start tracing document
+template <typename Handler>
+void BasicXMLParser<Handler>::startTracing() {
+
+    TRACE("START DOCUMENT");
+    INSTRUMENTED(instrumentation.start());
+    if constexpr (HANDLES(handleStartDocument))
+        if (SUBSCRIBED(START_DOCUMENT))
+            INSTRUMENT_HANDLER(START_DOCUMENT, handler.handleStartDocument());
+}
+
+// stop the parse with the error, with the message made from the parts.
+// The error is thrown to parse() or parseFragment(), so the parse has no checks for errors
+template <typename Handler>
+template <typename... Parts>
+[[noreturn]] void BasicXMLParser<Handler>::parseError(XMLErrorCode code, const Parts&... parts) {
+
+    XMLParseError error;
+    error.code = code;
+    error.offset = totalBytes - static_cast<long long>(content.size());
+    switch (code) {
+    case XMLErrorCode::DECLARATION:             error.tokenKind = XMLParserHandler::DECLARATION; break;
+    case XMLErrorCode::DOCTYPE:                 error.tokenKind = XMLParserHandler::DOCTYPE; break;
+    case XMLErrorCode::COMMENT:                 error.tokenKind = XMLParserHandler::COMMENT; break;
+    case XMLErrorCode::CDATA:                   error.tokenKind = XMLParserHandler::CDATA; break;
+    case XMLErrorCode::PROCESSING_INSTRUCTION:  error.tokenKind = XMLParserHandler::PROCESSING_INSTRUCTION; break;
+    case XMLErrorCode::START_TAG_NAME:
+    case XMLErrorCode::UNTERMINATED_START_TAG:  error.tokenKind = XMLParserHandler::START_TAG; break;
+    case XMLErrorCode::END_TAG_NAME:
+    case XMLErrorCode::UNTERMINATED_END_TAG:    error.tokenKind = XMLParserHandler::END_TAG; break;
+    case XMLErrorCode::NAMESPACE:               error.tokenKind = XMLParserHandler::NAMESPACE; break;
+    case XMLErrorCode::ATTRIBUTE:               error.tokenKind = XMLParserHandler::ATTRIBUTE; break;
+    default:                                    error.tokenKind = 0; break;
+    }
+    (error.message.append(std::string_view(parts)), ...);
+    throw error;
+}
+
+// stop the parse with an input error, with the message of the input source when it has one
+template <typename Handler>
+[[noreturn]] void BasicXMLParser<Handler>::inputError() {
+
+    if (!input.error().empty()) {
+        parseError(XMLErrorCode::INPUT, "input error : ", input.error());
+    }
+    parseError(XMLErrorCode::INPUT, "parser error : File input error");
+}
+
+// check for file input
+template <typename Handler>
+void BasicXMLParser<Handler>::checkFIleInput() {
+
+    INSTRUMENTED(const Instrumentation::Ticks refillStart = Instrumentation::now());
+    long bytesRead = input.refill(content);
+    INSTRUMENTED(instrumentation.refill(refillStart, bytesRead));
+    if (bytesRead < 0) {
+        inputError();
+    }
+    if (bytesRead == 0) {
+        parseError(XMLErrorCode::EMPTY_FILE, "parser error : Empty file");
+    }
+    totalBytes += bytesRead;
+    content.remove_prefix(std::min(content.find_first_not_of(WHITESPACE), content.size()));
+}
+
+// check if declaration
+template <typename Handler>
+bool BasicXMLParser<Handler>::isXMLDeclaration() {
+
+    // the content may be shorter than the declaration, e.g., a truncated document
+    return content.compare(0, "<?xml "sv.size(), "<?xml "sv) == 0;
+}
+
+// parse XML declaration
+template <typename Handler>
+void BasicXMLParser<Handler>::parseXMLDeclaration() {
+
+    assert(content.compare(0, "<?xml "sv.size(), "<?xml "sv) == 0);
+
+    // the whole declaration is in the content, so the scans of its parts stop before the end of the content
+    if (content.find("?>"sv, "<?xml "sv.size()) == content.npos) {
+        parseError(XMLErrorCode::DECLARATION, "parser error: Unterminated XML declaration");
+    }
+    content.remove_prefix("<?xml"sv.size());
+    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+
+    // parse required version
+    std::size_t nameEndPosition = content.find_first_of("= ");
+    if (nameEndPosition == content.npos) {
+        parseError(XMLErrorCode::DECLARATION, "parser error: Missing required first attribute version in XML declaration");
+    }
+    const std::string_view attr(content.substr(0, nameEndPosition));
+    content.remove_prefix(nameEndPosition);
+    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+    content.remove_prefix("="sv.size());
+    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+    const auto delimiter = content[0];
+    if (delimiter != '"' && delimiter != '\'') {
+        parseError(XMLErrorCode::DECLARATION, "parser error: Invalid start delimiter for version in XML declaration");
+    }
+    content.remove_prefix("\""sv.size());
+    std::size_t valueEndPosition = content.find(delimiter);
+    if (valueEndPosition == content.npos) {
+        parseError(XMLErrorCode::DECLARATION, "parser error: Invalid end delimiter for version in XML declaration");
+    }
+    if (attr != "version"sv) {
+        parseError(XMLErrorCode::DECLARATION, "parser error: Missing required first attribute version in XML declaration");
+    }
+    [[maybe_unused]] const std::string_view version(content.substr(0, valueEndPosition));
+    content.remove_prefix(valueEndPosition);
+    content.remove_prefix("\""sv.size());
+    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+
+    // parse optional encoding and standalone attributes
+    std::optional<std::string_view> encoding;
+    std::optional<std::string_view> standalone;
+    if (content[0] != '?') {
+        std::size_t nameEndPosition = content.find_first_of("= ");
+        if (nameEndPosition == content.npos) {
+            parseError(XMLErrorCode::DECLARATION, "parser error: Incomplete attribute in XML declaration");
+        }
+        const std::string_view attr2(content.substr(0, nameEndPosition));
+        content.remove_prefix(nameEndPosition);
+        content.remove_prefix(content.find_first_not_of(WHITESPACE));
+        assert(content.compare(0, "="sv.size(), "="sv) == 0);
+        content.remove_prefix("="sv.size());
+        content.remove_prefix(content.find_first_not_of(WHITESPACE));
+        auto delimiter2 = content[0];
+        if (delimiter2 != '"' && delimiter2 != '\'') {
+            parseError(XMLErrorCode::DECLARATION, "parser error: Invalid end delimiter for attribute ", attr2, " in XML declaration");
+        }
+        content.remove_prefix("\""sv.size());
+        std::size_t valueEndPosition = content.find(delimiter2);
+        if (valueEndPosition == content.npos) {
+            parseError(XMLErrorCode::DECLARATION, "parser error: Incomplete attribute ", attr2, " in XML declaration");
+        }
+        if (attr2 == "encoding"sv) {
+            encoding = content.substr(0, valueEndPosition);
+        }
+        else if (attr2 == "standalone"sv) {
+            standalone = content.substr(0, valueEndPosition);
+        }
+        else {
+            parseError(XMLErrorCode::DECLARATION, "parser error: Invalid attribute ", attr2, " in XML declaration");
+        }
+        content.remove_prefix(valueEndPosition + 1);
+        content.remove_prefix(content.find_first_not_of(WHITESPACE));
+    }
+    if (content[0] != '?') {
+        std::size_t nameEndPosition = content.find_first_of("= ");
+        if (nameEndPosition == content.npos) {
+            parseError(XMLErrorCode::DECLARATION, "parser error: Incomplete attribute in XML declaration");
+        }
+        const std::string_view attr2(content.substr(0, nameEndPosition));
+        content.remove_prefix(nameEndPosition);
+        content.remove_prefix(content.find_first_not_of(WHITESPACE));
+        content.remove_prefix("="sv.size());
+        content.remove_prefix(content.find_first_not_of(WHITESPACE));
+        const auto delimiter2 = content[0];
+        if (delimiter2 != '"' && delimiter2 != '\'') {
+            parseError(XMLErrorCode::DECLARATION, "parser error: Invalid end delimiter for attribute ", attr2, " in XML declaration");
+        }
+        content.remove_prefix("\""sv.size());
+        std::size_t valueEndPosition = content.find(delimiter2);
+        if (valueEndPosition == content.npos) {
+            parseError(XMLErrorCode::DECLARATION, "parser error: Incomplete attribute ", attr2, " in XML declaration");
+        }
+        if (!standalone && attr2 == "standalone"sv) {
+            standalone = content.substr(0, valueEndPosition);
+        }
+        else {
+            parseError(XMLErrorCode::DECLARATION, "parser error: Invalid attribute ", attr2, " in XML declaration");
+        }
+        // assert(content[valueEndPosition + 1] == '"');
+        content.remove_prefix(valueEndPosition + 1);
+        content.remove_prefix(content.find_first_not_of(WHITESPACE));
+    }
+    TRACE("XML DECLARATION", "version", version, "encoding", (encoding ? *encoding : ""), "standalone", (standalone ? *standalone : ""));
+    if (content.compare(0, "?>"sv.size(), "?>"sv) != 0) {
+        parseError(XMLErrorCode::DECLARATION, "parser error: Unterminated XML declaration");
+    }
+    content.remove_prefix("?>"sv.size());
+    content.remove_prefix(std::min(content.find_first_not_of(WHITESPACE), content.size()));
+    if constexpr (HANDLES(handleDeclaration))
+        if (SUBSCRIBED(DECLARATION))
+            INSTRUMENT_HANDLER(DECLARATION, handler.handleDeclaration(version, encoding, standalone));
+}
+
+// check if DOCTYPE
+template <typename Handler>
+bool BasicXMLParser<Handler>::isDOCTYPE() {
+
+    // the content may be shorter than the DOCTYPE, e.g., a truncated document
+    return content.compare(0, "<!DOCTYPE "sv.size(), "<!DOCTYPE "sv) == 0;
+}
+
+// parse DOCTYPE
+template <typename Handler>
+void BasicXMLParser<Handler>::parseDOCTYPE() {
+
+    assert(content.compare(0, "<!DOCTYPE "sv.size(), "<!DOCTYPE "sv) == 0);
+    content.remove_prefix("<!DOCTYPE"sv.size());
+    int depthAngleBrackets = 1;
+    bool inSingleQuote = false;
+    bool inDoubleQuote = false;
+    bool inComment = false;
+    std::size_t p = 0;
+    while ((p = content.find_first_of("<>'\"-"sv, p)) != content.npos) {
+        if (content.compare(p, "<!--"sv.size(), "<!--"sv) == 0) {
+            inComment = true;
+            p += "<!--"sv.size();
+            continue;
+        }
+        else if (content.compare(p, "-->"sv.size(), "-->"sv) == 0) {
+            inComment = false;
+            p += "-->"sv.size();
+            continue;
+        }
+        if (inComment) {
+            ++p;
+            continue;
+        }
+        if (content[p] == '<' && !inSingleQuote && !inDoubleQuote) {
+            ++depthAngleBrackets;
+        }
+        else if (content[p] == '>' && !inSingleQuote && !inDoubleQuote) {
+            --depthAngleBrackets;
+        }
+        else if (content[p] == '\'') {
+            inSingleQuote = !inSingleQuote;
+        }
+        else if (content[p] == '"') {
+            inDoubleQuote = !inDoubleQuote;
+        }
+        if (depthAngleBrackets == 0)
+            break;
+        ++p;
+    }
+    [[maybe_unused]] const std::string_view contents(content.substr(0, p));
+    TRACE("DOCTYPE", "contents", contents);
+    if (p == content.npos) {
+        parseError(XMLErrorCode::DOCTYPE, "parser error : Unterminated DOCTYPE");
+    }
+    content.remove_prefix(p);
+    content.remove_prefix(">"sv.size());
+    content.remove_prefix(std::min(content.find_first_not_of(WHITESPACE), content.size()));
+    if constexpr (HANDLES(handleDOCTYPE))
+        if (SUBSCRIBED(DOCTYPE))
+            INSTRUMENT_HANDLER(DOCTYPE, handler.handleDOCTYPE());
+}
+
+// refill content preserving unprocessed
+template <typename Handler>
+void BasicXMLParser<Handler>::refillContentUnprocessed() {
+
+    // the refill moves the content, so report the run of raw tokens so far and continue it after
+    const bool inRaw = rawStart != nullptr;
+    flushRaw();
+    flushBatch();
+    INSTRUMENTED(instrumentation.endToken(content.data()));
+    INSTRUMENTED(const Instrumentation::Ticks refillStart = Instrumentation::now());
+    long bytesRead = input.refill(content);
+    INSTRUMENTED(instrumentation.refill(refillStart, bytesRead));
+    if (bytesRead < 0) {
+        inputError();
+    }
+    if (bytesRead == 0) {
+        doneReading = true;
+    }
+    totalBytes += bytesRead;
+    if (inRaw)
+        rawStart = content.data();
+
+    // the index is for the previous content
+    if (index)
+        index->reset();
+}
+
+// check if character entity references
+template <typename Handler>
+bool BasicXMLParser<Handler>::isCharacterEntityReferences() {
+
+    return (content[0] == '&');
+}
+
+// parse character entity references
+template <typename Handler>
+void BasicXMLParser<Handler>::parseCharacterEntityReferences() {
+
+    std::string_view unescapedCharacter;
+    std::string_view escapedCharacter;
+    if (content[1] == 'l' && content[2] == 't' && content[3] == ';') {
+        unescapedCharacter = "<";
+        escapedCharacter = "&lt;"sv;
+    } else if (content[1] == 'g' && content[2] == 't' && content[3] == ';') {
+        unescapedCharacter = ">";
+        escapedCharacter = "&gt;"sv;
+    } else if (content[1] == 'a' && content[2] == 'm' && content[3] == 'p' && content[4] == ';') {
+        unescapedCharacter = "&";
+        escapedCharacter = "&amp;"sv;
+    } else {
+        unescapedCharacter = "&";
+        escapedCharacter = "&"sv;
+    }
+    assert(content.compare(0, escapedCharacter.size(), escapedCharacter) == 0);
+    [[maybe_unused]] const std::string_view reference(content.substr(0, escapedCharacter.size()));
+    content.remove_prefix(escapedCharacter.size());
+    [[maybe_unused]] const std::string_view characters(unescapedCharacter);
+    TRACE("CHARACTERS", "characters", characters);
+    if constexpr (HANDLES(handleCharacterEntityReferences) || HANDLES(handleBatch)) {
+        if (SUBSCRIBED(CHARACTER_ENTITY_REFERENCES)) {
+            if (isBatching())
+                batchEvent(XMLParserHandler::CHARACTER_ENTITY_REFERENCES, 0, reference);
+            else
+                INSTRUMENT_HANDLER(CHARACTER_ENTITY_REFERENCES, handler.handleCharacterEntityReferences(characters));
+        }
+    }
+}
+
+// check if character non-entity references
+template <typename Handler>
+bool BasicXMLParser<Handler>::isCharacterNonEntityReferences() {
+
+    return (content[0] != '<');
+}
+
+// parse character non-entity references
+template <typename Handler>
+void BasicXMLParser<Handler>::parseCharacterNonEntityReferences() {
+
+    assert(content[0] != '<' && content[0] != '&');
+    std::size_t characterEndPosition = characterEnd();
+    const std::string_view characters(content.substr(0, characterEndPosition));
+    TRACE("CHARACTERS", "characters", characters);
+    content.remove_prefix(characters.size());
+    if constexpr (HANDLES(handleCharacterNonEntityReferences) || HANDLES(handleBatch)) {
+        if (SUBSCRIBED(CHARACTER_NON_ENTITY_REFERENCES)) {
+            if (isBatching())
+                batchEvent(XMLParserHandler::CHARACTER_NON_ENTITY_REFERENCES, 0, characters);
+            else
+                INSTRUMENT_HANDLER(CHARACTER_NON_ENTITY_REFERENCES, handler.handleCharacterNonEntityReferences(characters));
+        }
+    }
+}
+
+// check if comment
+template <typename Handler>
+bool BasicXMLParser<Handler>::isXMLComment() {
+
+    return (content[1] == '!' /* && content[0] == '<' */ && content[2] == '-' && content[3] == '-');
+}
+
+// parse XML comment
+template <typename Handler>
+void BasicXMLParser<Handler>::parseXMLComment() {
+
+    assert(content.compare(0, "<!--"sv.size(), "<!--"sv) == 0);
+    std::size_t tagEndPosition = content.find("-->"sv, "<!--"sv.size());
+    if (tagEndPosition == content.npos) {
+
+        // refill content preserving unprocessed, including the start of the comment
+        refillContentUnprocessed();
+        tagEndPosition = content.find("-->"sv, "<!--"sv.size());
+        if (tagEndPosition == content.npos) {
+            parseError(XMLErrorCode::COMMENT, "parser error : Unterminated XML comment");
+        }
+    }
+    content.remove_prefix("<!--"sv.size());
+    tagEndPosition -= "<!--"sv.size();
+    [[maybe_unused]] const std::string_view comment(content.substr(0, tagEndPosition));
+    TRACE("COMMENT", "content", comment);
+    content.remove_prefix(tagEndPosition);
+    if constexpr (HANDLES(handleComment) || HANDLES(handleBatch)) {
+        if (SUBSCRIBED(COMMENT)) {
+            if (isBatching())
+                batchEvent(XMLParserHandler::COMMENT, 0, comment);
+            else
+                INSTRUMENT_HANDLER(COMMENT, handler.handleComment(comment));
+        }
+    }
+}
+
+// check if CDATA
+template <typename Handler>
+bool BasicXMLParser<Handler>::isCDATA() {
+
+    return (content[1] == '!' /* && content[0] == '<' */ && content[2] == '[' && content[3] == 'C' && content[4] == 'D' &&
+            content[5] == 'A' && content[6] == 'T' && content[7] == 'A' && content[8] == '[');
+}
+
+// parse CDATA
+template <typename Handler>
+void BasicXMLParser<Handler>::parseCDATA() {
+
+    std::size_t tagEndPosition = content.find("]]>"sv, "<![CDATA["sv.size());
+    if (tagEndPosition == content.npos) {
+
+        // refill content preserving unprocessed, including the start of the CDATA
+        refillContentUnprocessed();
+        tagEndPosition = content.find("]]>"sv, "<![CDATA["sv.size());
+        if (tagEndPosition == content.npos) {
+            parseError(XMLErrorCode::CDATA, "parser error : Unterminated CDATA");
+        }
+    }
+    content.remove_prefix("<![CDATA["sv.size());
+    tagEndPosition -= "<![CDATA["sv.size();
+    const std::string_view characters(content.substr(0, tagEndPosition));
+    TRACE("CDATA", "characters", characters);
+    content.remove_prefix(tagEndPosition);
+    content.remove_prefix("]]>"sv.size());
+    if constexpr (HANDLES(handleCDATA) || HANDLES(handleBatch)) {
+        if (SUBSCRIBED(CDATA)) {
+            if (isBatching())
+                batchEvent(XMLParserHandler::CDATA, 0, characters);
+            else
+                INSTRUMENT_HANDLER(CDATA, handler.handleCDATA(characters));
+        }
+    }
+}
+
+// check if processing instruction
+template <typename Handler>
+bool BasicXMLParser<Handler>::isProcessingInstruction() {
+
+    return (content[1] == '?' /* && content[0] == '<' */);
+}
+
+// parse processing instruction
+template <typename Handler>
+void BasicXMLParser<Handler>::parseProcessingInstruction() {
+
+    assert(content.compare(0, "<?"sv.size(), "<?"sv) == 0);
+    content.remove_prefix("<?"sv.size());
+    std::size_t tagEndPosition = content.find("?>"sv);
+    if (tagEndPosition == content.npos) {
+        parseError(XMLErrorCode::PROCESSING_INSTRUCTION, "parser error: Incomplete XML declaration");
+    }
+    std::size_t nameEndPosition = findNameEnd(content);
+    if (nameEndPosition == content.npos) {
+        parseError(XMLErrorCode::PROCESSING_INSTRUCTION, "parser error : Unterminated processing instruction");
+    }
+    [[maybe_unused]] const std::string_view target(content.substr(0, nameEndPosition));
+    [[maybe_unused]] const std::string_view data(content.substr(nameEndPosition, tagEndPosition - nameEndPosition));
+    TRACE("PI", "target", target, "data", data);
+    content.remove_prefix(tagEndPosition);
+    assert(content.compare(0, "?>"sv.size(), "?>"sv) == 0);
+    content.remove_prefix("?>"sv.size());
+    if constexpr (HANDLES(handleProcessingInstruction)) {
+        if (SUBSCRIBED(PROCESSING_INSTRUCTION)) {
+            flushBatch();
+            INSTRUMENT_HANDLER(PROCESSING_INSTRUCTION, handler.handleProcessingInstruction(target, data));
+        }
+    }
+}
+
+// check if end tag
+template <typename Handler>
+bool BasicXMLParser<Handler>::isEndTag() {
+
+    return (content[1] == '/' /* && content[0] == '<' */);
+}
+
+// parse end tag
+template <typename Handler>
+void BasicXMLParser<Handler>::parseEndTag() {
+
+    assert(content.compare(0, "</"sv.size(), "</"sv) == 0);
+    content.remove_prefix("</"sv.size());
+    if (content[0] == ':') {
+        parseError(XMLErrorCode::END_TAG_NAME, "parser error : Invalid end tag name");
+    }
+    std::size_t nameEndPosition = nameEnd();
+    size_t colonPosition = 0;
+    if (nameEndPosition != content.npos && content[nameEndPosition] == ':') {
+        colonPosition = nameEndPosition;
+        nameEndPosition = nameEnd(nameEndPosition + 1);
+    }
+    if (nameEndPosition == content.npos) {
+        parseError(XMLErrorCode::UNTERMINATED_END_TAG, "parser error : Unterminated end tag '", content, "'");
+    }
+    const std::string_view qName(content.substr(0, nameEndPosition));
+    if (qName.empty()) {
+        parseError(XMLErrorCode::END_TAG_NAME, "parser error: EndTag: invalid element name");
+    }
+    [[maybe_unused]] const std::string_view prefix(qName.substr(0, colonPosition));
+    [[maybe_unused]] const std::string_view localName(qName.substr(colonPosition ? colonPosition + 1 : 0));
+    TRACE("END TAG", "qName", qName, "prefix", prefix, "localName", localName);
+    content.remove_prefix(nameEndPosition);
+    content.remove_prefix(std::min(content.find_first_not_of(WHITESPACE), content.size()));
+    if (content.empty() || content[0] != '>') {
+        parseError(XMLErrorCode::UNTERMINATED_END_TAG, "parser error : Unterminated end tag '", qName, "'");
+    }
+    content.remove_prefix(">"sv.size());
+    if constexpr (HANDLES(handleEndTag) || HANDLES(handleBatch)) {
+        if (SUBSCRIBED(END_TAG)) {
+            if (isBatching())
+                batchEvent(XMLParserHandler::END_TAG, names.intern(prefix, localName), qName);
+            else
+                INSTRUMENT_HANDLER(END_TAG, handler.handleEndTag(qName, prefix, localName, names.intern(prefix, localName)));
+        }
+    }
+}
+
+// check if start tag
+template <typename Handler>
+bool BasicXMLParser<Handler>::isStartTag() {
+
+    return (content[0] == '<');
+}
+
+// parse start tag, returning the qualified name
+template <typename Handler>
+std::string_view BasicXMLParser<Handler>::parseStartTag() {
+
+    assert(content.compare(0, "<"sv.size(), "<"sv) == 0);
+    content.remove_prefix("<"sv.size());
+    if (content[0] == ':') {
+        parseError(XMLErrorCode::START_TAG_NAME, "parser error : Invalid start tag name");
+    }
+    std::size_t nameEndPosition = nameEnd();
+    size_t colonPosition = 0;
+    if (nameEndPosition != content.npos && content[nameEndPosition] == ':') {
+        colonPosition = nameEndPosition;
+        nameEndPosition = nameEnd(nameEndPosition + 1);
+    }
+    if (nameEndPosition == content.npos) {
+        parseError(XMLErrorCode::UNTERMINATED_START_TAG, "parser error : Unterminated start tag '", content, "'");
+    }
+    const std::string_view qName(content.substr(0, nameEndPosition));
+    if (qName.empty()) {
+        parseError(XMLErrorCode::START_TAG_NAME, "parser error: StartTag: invalid element name");
+    }
+    [[maybe_unused]] const std::string_view prefix(qName.substr(0, colonPosition));
+    const std::string_view localName(qName.substr(colonPosition ? colonPosition + 1 : 0, nameEndPosition));
+    TRACE("START TAG", "qName", qName, "prefix", prefix, "localName", localName);
+    content.remove_prefix(nameEndPosition);
+    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+
+    // the prefix can be declared on the start tag itself, e.g., the root unit, before the name is interned
+    if (!prefix.empty() && !names.isBound(prefix)) {
+        bindStartTagNamespaces();
+
+        // an undeclared prefix is not in any namespace, and is not scanned for again
+        if (!names.isBound(prefix))
+            names.bindPrefix(prefix, ""sv);
+    }
+    if constexpr (HANDLES(handleStartTag) || HANDLES(handleBatch)) {
+        if (SUBSCRIBED(START_TAG)) {
+            if (isBatching())
+                batchEvent(XMLParserHandler::START_TAG, names.intern(prefix, localName), qName);
+            else
+                INSTRUMENT_HANDLER(START_TAG, skipRequested = handler.handleStartTag(qName, prefix, localName, names.intern(prefix, localName)) == XMLParserHandler::SKIP);
+        }
+    }
+
+    return qName;
+}
+
+// bind the namespace declarations of the rest of the start tag without consuming it.
+// Malformed attributes are left for the parse of the attributes to report
+template <typename Handler>
+void BasicXMLParser<Handler>::bindStartTagNamespaces() {
+
+    std::size_t pos = 0;
+    while (pos < content.size() && content[pos] != '>' && content[pos] != '/') {
+        const std::size_t equalPosition = content.find('=', pos);
+        const std::size_t valueStart = equalPosition == content.npos ? content.npos : content.find_first_not_of(WHITESPACE, equalPosition + 1);
+        if (valueStart == content.npos || (content[valueStart] != '"' && content[valueStart] != '\''))
+            return;
+        const std::size_t valueEnd = content.find(content[valueStart], valueStart + 1);
+        if (valueEnd == content.npos)
+            return;
+        const std::string_view attributeName(content.substr(pos, content.find_first_of(" \n\t\r="sv, pos) - pos));
+        if (attributeName == "xmlns"sv || attributeName.substr(0, "xmlns:"sv.size()) == "xmlns:"sv)
+            names.bindPrefix(attributeName.substr(std::min(attributeName.size(), "xmlns:"sv.size())), content.substr(valueStart + 1, valueEnd - (valueStart + 1)));
+        pos = content.find_first_not_of(WHITESPACE, valueEnd + 1);
+    }
+}
+
+// end of an empty element, i.e., "/>", as an end tag
+template <typename Handler>
+void BasicXMLParser<Handler>::endEmptyElement(std::string_view qName) {
+
+    const std::size_t colonPosition = qName.find(':');
+    [[maybe_unused]] const std::string_view prefix(colonPosition == qName.npos ? ""sv : qName.substr(0, colonPosition));
+    [[maybe_unused]] const std::string_view localName(colonPosition == qName.npos ? qName : qName.substr(colonPosition + 1));
+    TRACE("END TAG", "qName", qName, "prefix", prefix, "localName", localName);
+    if constexpr (HANDLES(handleEndTag) || HANDLES(handleBatch)) {
+        if (SUBSCRIBED(END_TAG)) {
+            if (isBatching())
+                batchEvent(XMLParserHandler::END_TAG, names.intern(prefix, localName), qName);
+            else
+                INSTRUMENT_HANDLER(END_TAG, handler.handleEndTag(qName, prefix, localName, names.intern(prefix, localName)));
+        }
+    }
+}
+
+// skip the content of an element up to its end tag, with only the bytes and newlines reported.
+// The walk finds each markup with a scan for '<' that counts the newlines in the same pass,
+// and only keeps the nesting depth of the tags, so the content is not tokenized into events
+template <typename Handler>
+void BasicXMLParser<Handler>::skipElementContent() {
+
+    rawToken(XMLParserHandler::SKIPPED);
+    long long skippedBytes = 0;
+    long long skippedNewlines = 0;
+    int skipDepth = 1;
+    while (skipDepth > 0) {
+        if (!doneReading && content.size() < BLOCK_SIZE) {
+
+            // refill content preserving unprocessed
+            refillContentUnprocessed();
+        }
+        if (doneReading && content.empty())
+            break;
+
+        // walk the markup of the content, up to the end tag of the element or a markup not in the content
+        const char* const contentEnd = content.data() + content.size();
+        const char* position = content.data();
+        std::size_t newlines = 0;
+        XMLErrorCode unterminated = XMLErrorCode::NONE;
+        while (true) {
+            const std::size_t markupPosition = findTagStart(std::string_view(position, static_cast<std::size_t>(contentEnd - position)), 0, newlines);
+            if (markupPosition == content.npos) {
+                position = contentEnd;
+                break;
+            }
+            const char* const markup = position + markupPosition;
+            const std::string_view rest(markup, static_cast<std::size_t>(contentEnd - markup));
+            std::size_t markupEnd = content.npos;
+            if (rest.size() < "</"sv.size()) {
+                unterminated = XMLErrorCode::UNTERMINATED_START_TAG;
+            } else if (rest[1] == '!' || rest[1] == '?') {
+
+                // comments, CDATA, and processing instructions do not change the depth
+                if (rest.compare(0, "<!--"sv.size(), "<!--"sv) == 0) {
+                    markupEnd = rest.find("-->"sv, "<!--"sv.size());
+                    markupEnd = markupEnd == rest.npos ? markupEnd : markupEnd + "-->"sv.size();
+                    unterminated = XMLErrorCode::COMMENT;
+                } else if (rest.compare(0, "<![CDATA["sv.size(), "<![CDATA["sv) == 0) {
+                    markupEnd = rest.find("]]>"sv, "<![CDATA["sv.size());
+                    markupEnd = markupEnd == rest.npos ? markupEnd : markupEnd + "]]>"sv.size();
+                    unterminated = XMLErrorCode::CDATA;
+                } else if (rest[1] == '?') {
+                    markupEnd = rest.find("?>"sv, "<?"sv.size());
+                    markupEnd = markupEnd == rest.npos ? markupEnd : markupEnd + "?>"sv.size();
+                    unterminated = XMLErrorCode::PROCESSING_INSTRUCTION;
+                } else {
+                    markupEnd = rest.find('>');
+                    markupEnd = markupEnd == rest.npos ? markupEnd : markupEnd + ">"sv.size();
+                    unterminated = XMLErrorCode::CONTENT;
+                }
+                if (markupEnd != rest.npos)
+                    newlines += countNewlines(rest.substr(0, markupEnd));
+            } else {
+
+                // tag, with the '>' of the tag outside of quoted attribute values
+                unterminated = rest[1] == '/' ? XMLErrorCode::UNTERMINATED_END_TAG : XMLErrorCode::UNTERMINATED_START_TAG;
+                std::size_t tagNewlines = 0;
+                std::size_t pos = 1;
+                while (pos < rest.size() && rest[pos] != '>') {
+                    if (rest[pos] == '"' || rest[pos] == '\'') {
+                        const std::size_t quoteEnd = rest.find(rest[pos], pos + 1);
+                        if (quoteEnd == rest.npos) {
+                            pos = rest.size();
+                            break;
+                        }
+                        tagNewlines += countNewlines(rest.substr(pos + 1, quoteEnd - pos - 1));
+                        pos = quoteEnd;
+                    }
+                    tagNewlines += rest[pos] == '\n';
+                    ++pos;
+                }
+                if (pos < rest.size()) {
+                    markupEnd = pos + ">"sv.size();
+                    newlines += tagNewlines;
+
+                    // the end tag of the element is parsed after the skip
+                    if (rest[1] == '/') {
+                        if (--skipDepth == 0) {
+                            newlines -= tagNewlines;
+                            position = markup;
+                            break;
+                        }
+                    } else if (rest[pos - 1] != '/') {
+                        ++skipDepth;
+                    }
+                }
+            }
+            if (markupEnd == rest.npos) {
+                position = markup;
+                break;
+            }
+            unterminated = XMLErrorCode::NONE;
+            position = markup + markupEnd;
+        }
+        const std::size_t walked = static_cast<std::size_t>(position - content.data());
+        skippedBytes += static_cast<long long>(walked);
+        skippedNewlines += static_cast<long long>(newlines);
+        content.remove_prefix(walked);
+
+        // markup that is not in the content is refilled, or is an error at the end of the input
+        if (skipDepth > 0 && walked == 0 && unterminated != XMLErrorCode::NONE) {
+            if (doneReading)
+                parseError(unterminated, "parser error : Unterminated markup in skipped element '", content.substr(0, content.find_first_of(WHITESPACE)), "'");
+
+            // refill content preserving unprocessed, including the start of the markup
+            refillContentUnprocessed();
+        }
+    }
+    TRACE("SKIPPED", "bytes", skippedBytes, "newlines", skippedNewlines);
+    if constexpr (HANDLES(handleSkipped)) {
+        if (SUBSCRIBED(SKIPPED)) {
+            flushBatch();
+            INSTRUMENT_HANDLER(SKIPPED, handler.handleSkipped(skippedBytes, skippedNewlines));
+        }
+    }
+}
+
+// check if namespace
+template <typename Handler>
+bool BasicXMLParser<Handler>::isXMLNamespace() {
+
+    return (content[0] == 'x' && content[1] == 'm' && content[2] == 'l' && content[3] == 'n' && content[4] == 's' && (content[5] == ':' || content[5] == '='));
+}
+
+// parse XML namespace
+template <typename Handler>
+void BasicXMLParser<Handler>::parseXMLNamespace() {
+
+    assert(content.compare(0, "xmlns"sv.size(), "xmlns"sv) == 0);
+    content.remove_prefix("xmlns"sv.size());
+    std::size_t nameEndPosition = content.find('=');
+    if (nameEndPosition == content.npos) {
+        parseError(XMLErrorCode::NAMESPACE, "parser error : incomplete namespace");
+    }
+    std::size_t prefixSize = 0;
+    if (content[0] == ':') {
+        content.remove_prefix(":"sv.size());
+        --nameEndPosition;
+        prefixSize = nameEndPosition;
+    }
+    [[maybe_unused]] const std::string_view prefix(content.substr(0, prefixSize));
+    content.remove_prefix(nameEndPosition);
+    content.remove_prefix("="sv.size());
+    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+    if (content.empty()) {
+        parseError(XMLErrorCode::NAMESPACE, "parser error : incomplete namespace");
+    }
+    const auto delimiter = content[0];
+    if (delimiter != '"' && delimiter != '\'') {
+        parseError(XMLErrorCode::NAMESPACE, "parser error : incomplete namespace");
+    }
+    content.remove_prefix("\""sv.size());
+    std::size_t valueEndPosition = quoteEnd(delimiter, 0);
+    if (valueEndPosition == content.npos) {
+        parseError(XMLErrorCode::NAMESPACE, "parser error : incomplete namespace");
+    }
+    [[maybe_unused]] const std::string_view uri(content.substr(0, valueEndPosition));
+    TRACE("NAMESPACE", "prefix", prefix, "uri", uri);
+    content.remove_prefix(valueEndPosition);
+    assert(content.compare(0, "\""sv.size(), "\""sv) == 0);
+    content.remove_prefix("\""sv.size());
+    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+    names.bindPrefix(prefix, uri);
+    if constexpr (HANDLES(handleNamespace)) {
+        if (SUBSCRIBED(NAMESPACE)) {
+            flushBatch();
+            INSTRUMENT_HANDLER(NAMESPACE, handler.handleNamespace(prefix, uri));
+        }
+    }
+}
+
+// parse attribute
+template <typename Handler>
+void BasicXMLParser<Handler>::parseAttribute() {
+    
+    std::size_t nameEndPosition = nameEnd();
+    size_t colonPosition = 0;
+    if (nameEndPosition != content.npos && content[nameEndPosition] == ':') {
+        colonPosition = nameEndPosition;
+        nameEndPosition = nameEnd(nameEndPosition + 1);
+    }
+    if (nameEndPosition == content.npos) {
+        parseError(XMLErrorCode::ATTRIBUTE, "parser error : Empty attribute name");
+    }
+    std::string_view qName(content.substr(0, nameEndPosition));
+    [[maybe_unused]] std::string_view prefix(qName.substr(0, colonPosition));
+    std::string_view localName(qName.substr(colonPosition ? colonPosition + 1 : 0));
+    content.remove_prefix(nameEndPosition);
+    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+    if (content.empty()) {
+        parseError(XMLErrorCode::ATTRIBUTE, "parser error : attribute ", qName, " incomplete attribute");
+    }
+    if (content[0] != '=') {
+        parseError(XMLErrorCode::ATTRIBUTE, "parser error : attribute ", qName, " missing =");
+    }
+    content.remove_prefix("="sv.size());
+    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+    const auto delimiter = content[0];
+    if (delimiter != '"' && delimiter != '\'') {
+        parseError(XMLErrorCode::ATTRIBUTE, "parser error : attribute ", qName, " missing delimiter");
+    }
+    content.remove_prefix("\""sv.size());
+    std::size_t valueEndPosition = quoteEnd(delimiter, 0);
+    if (valueEndPosition == content.npos) {
+        parseError(XMLErrorCode::ATTRIBUTE, "parser error : attribute ", qName, " missing delimiter");
+    }
+    const std::string_view value(content.substr(0, valueEndPosition));
+    TRACE("ATTRIBUTE", "qname", qName, "prefix", prefix, "localName", localName, "value", value);
+    content.remove_prefix(valueEndPosition);
+    content.remove_prefix("\""sv.size());
+    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+    if constexpr (HANDLES(handleAttribute) || HANDLES(handleBatch)) {
+        if (SUBSCRIBED(ATTRIBUTE)) {
+            if (isBatching())
+                batchEvent(XMLParserHandler::ATTRIBUTE, names.intern(prefix, localName), value);
+            else
+                INSTRUMENT_HANDLER(ATTRIBUTE, handler.handleAttribute(qName, prefix, localName, value, names.intern(prefix, localName)));
+        }
+    }
+}
+
+// skip attribute or namespace, with a single scan from the opening to the closing quote
+template <typename Handler>
+void BasicXMLParser<Handler>::skipAttribute() {
+
+    // names do not contain '=', so the value starts after the first one
+    const std::size_t equalPosition = content.find('=');
+    const std::size_t valueStartPosition = equalPosition == content.npos ? content.npos : content.find_first_not_of(WHITESPACE, equalPosition + 1);
+    if (valueStartPosition == content.npos || (content[valueStartPosition] != '"' && content[valueStartPosition] != '\'')) {
+        parseError(XMLErrorCode::ATTRIBUTE, "parser error : attribute missing delimiter");
+    }
+    const std::size_t valueEndPosition = quoteEnd(content[valueStartPosition], valueStartPosition + 1);
+    if (valueEndPosition == content.npos) {
+        parseError(XMLErrorCode::ATTRIBUTE, "parser error : attribute missing delimiter");
+    }
+    TRACE("ATTRIBUTE", "skipped", content.substr(0, valueEndPosition + 1));
+    content.remove_prefix(valueEndPosition + 1);
+    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+}
+
+// skip end tag, with only a match of the closing bracket
+template <typename Handler>
+void BasicXMLParser<Handler>::skipEndTag() {
+
+    assert(content.compare(0, "</"sv.size(), "</"sv) == 0);
+    const std::size_t tagEndPosition = tagEnd();
+    if (tagEndPosition == content.npos) {
+        parseError(XMLErrorCode::UNTERMINATED_END_TAG, "parser error : Unterminated end tag '", content.substr(0, content.find_first_of(WHITESPACE)), "'");
+    }
+    TRACE("END TAG", "skipped", content.substr(0, tagEndPosition + 1));
+    content.remove_prefix(tagEndPosition + 1);
+}
+
+// start or end a run of raw tokens for a token with the events,
+// where a token is raw if the handler subscribes to RAW but none of the events of the token
+template <typename Handler>
+void BasicXMLParser<Handler>::rawToken(unsigned int tokenEvents) {
+
+    INSTRUMENTED(instrumentation.token(tokenEvents, content.data()));
+    if constexpr (HANDLES(handleRaw)) {
+        if (SUBSCRIBED(RAW) && !(events & tokenEvents)) {
+            if (!rawStart)
+                rawStart = content.data();
+        } else {
+            flushRaw();
+        }
+    }
+}
+
+// report the current run of raw tokens
+template <typename Handler>
+void BasicXMLParser<Handler>::flushRaw() {
+
+    if constexpr (HANDLES(handleRaw)) {
+        if (rawStart) {
+            const std::string_view raw(rawStart, static_cast<std::size_t>(content.data() - rawStart));
+            rawStart = nullptr;
+            TRACE("RAW", "raw", raw);
+            if (!raw.empty()) {
+                flushBatch();
+                INSTRUMENT_HANDLER(RAW, handler.handleRaw(raw));
+            }
+        }
+    }
+}
+
+// events are reported in batches
+template <typename Handler>
+bool BasicXMLParser<Handler>::isBatching() const {
+
+    if constexpr (HANDLES(handleBatch))
+        return SUBSCRIBED(BATCH);
+    else
+        return false;
+}
+
+// add an event to the batch, reporting the batch when full
+template <typename Handler>
+void BasicXMLParser<Handler>::batchEvent(XMLParserHandler::Event kind, int nameID, std::string_view text) {
+
+    if constexpr (HANDLES(handleBatch)) {
+
+        // offsets are 32 bits, so a batch ends before a text too far from its base
+        if (batch->size == EventBatch::CAPACITY || (batch->size > 0 && static_cast<std::size_t>(text.data() - batch->base) > UINT32_MAX))
+            flushBatch();
+        if (batch->size == 0)
+            batch->base = text.data();
+
+        const std::size_t event = batch->size++;
+        batch->kinds[event] = static_cast<std::uint16_t>(kind);
+        batch->nameIDs[event] = nameID;
+        batch->offsets[event] = static_cast<std::uint32_t>(text.data() - batch->base);
+        batch->lengths[event] = static_cast<std::uint32_t>(text.size());
+    }
+}
+
+// report the current batch of events
+template <typename Handler>
+void BasicXMLParser<Handler>::flushBatch() {
+
+    if constexpr (HANDLES(handleBatch)) {
+        if (batch && batch->size > 0) {
+            TRACE("BATCH", "size", batch->size);
+            INSTRUMENT_HANDLER(BATCH, handler.handleBatch(*batch));
+            batch->size = 0;
+        }
+    }
+}
+
+// End tracing document
+template <typename Handler>
+void BasicXMLParser<Handler>::endTracing() {
+
+    TRACE("END DOCUMENT");
+    INSTRUMENTED(instrumentation.end(content.data()));
+    flushBatch();
+    if constexpr (HANDLES(handleEndDocument))
+        if (SUBSCRIBED(END_DOCUMENT))
+            INSTRUMENT_HANDLER(END_DOCUMENT, handler.handleEndDocument());
+}
+
+// parse content, i.e., elements, characters, comments, CDATA, and processing instructions
+template <typename Handler>
+void BasicXMLParser<Handler>::parseContent(bool isFragment) {
+
+    while (true) {
+        if (!doneReading && content.size() < BLOCK_SIZE) {
+
+            // refill content preserving unprocessed
+            refillContentUnprocessed();
+        }
+        if (doneReading && content.empty())
+            break;
+        if (isCharacterEntityReferences()) {
+
+            // parse character entity references
+            rawToken(XMLParserHandler::CHARACTER_ENTITY_REFERENCES);
+            parseCharacterEntityReferences();
+        } else if (isCharacterNonEntityReferences()) {
+
+            // parse character non-entity references
+            rawToken(XMLParserHandler::CHARACTER_NON_ENTITY_REFERENCES);
+            parseCharacterNonEntityReferences();
+        } else if (isXMLComment()) {
+
+            // parse XML comment
+            rawToken(XMLParserHandler::COMMENT);
+            parseXMLComment();
+            content.remove_prefix("-->"sv.size());
+        } else if (isCDATA()) {
+
+            // parse CDATA
+            rawToken(XMLParserHandler::CDATA);
+            parseCDATA();
+
+        } else if (isProcessingInstruction()) {
+
+            // parse processing instruction
+            rawToken(XMLParserHandler::PROCESSING_INSTRUCTION);
+            parseProcessingInstruction();
+        } else if (isEndTag()) {
+
+            // parse end tag, or only match the bracket when not consumed
+            rawToken(XMLParserHandler::END_TAG);
+            if (SUBSCRIBED(END_TAG))
+                parseEndTag();
+            else
+                skipEndTag();
+            --depth;
+            if (depth == 0 && !isFragment)
+                break;
+        } else if (isStartTag()) {
+
+            // parse start tag
+            rawToken(XMLParserHandler::START_TAG | XMLParserHandler::ATTRIBUTE | XMLParserHandler::NAMESPACE);
+            const std::string_view qName = parseStartTag();
+            
+            while (xmlNameMask[content[0]]) {
+                if (isXMLNamespace()) {
+
+                    // parse XML namespace, always, as the names use its prefix
+                    parseXMLNamespace();
+                } else {
+
+                    // parse attribute
+                    if (SUBSCRIBED(ATTRIBUTE))
+                        parseAttribute();
+                    else
+                        skipAttribute();
+                }
+            }
+            if (content[0] == '>') {
+                content.remove_prefix(">"sv.size());
+                ++depth;
+
+                // only the bytes and newlines of the content when the handler skips the element
+                if (skipRequested) {
+                    skipRequested = false;
+                    skipElementContent();
+                }
+            } else if (content[0] == '/' && content[1] == '>') {
+                assert(content.compare(0, "/>"sv.size(), "/>") == 0);
+                content.remove_prefix("/>"sv.size());
+                skipRequested = false;
+                endEmptyElement(qName);
+                if (depth == 0 && !isFragment)
+                    break;
+            }
+        } else {
+            parseError(XMLErrorCode::CONTENT, "parser error : invalid XML document");
+        }
+    }
+}
+
+// parse a fragment of element content, e.g., a sequence of elements, with the error, if any
+template <typename Handler>
+XMLParseError BasicXMLParser<Handler>::parseFragment() {
+
+    try {
+        startTracing();
+
+        // parse content until the end of the input
+        parseContent(true);
+        flushRaw();
+
+        // End tracing document
+        endTracing();
+
+        // fragments are reported in one total, e.g., after a parallel parse
+        INSTRUMENTED(Instrumentation::addFragment(instrumentation));
+    } catch (XMLParseError& error) {
+        return std::move(error);
+    }
+
+    return XMLParseError();
+}
+
+// parse the document, with the error in the XML or its input, if any
+template <typename Handler>
+XMLParseError BasicXMLParser<Handler>::parse() {
+
+    try {
+        parseDocument();
+    } catch (XMLParseError& error) {
+        return std::move(error);
+    }
+
+    return XMLParseError();
+}
+
+// parse the document
+template <typename Handler>
+void BasicXMLParser<Handler>::parseDocument() {
+
+    startTracing();
+    checkFIleInput();
+
+    if (isXMLDeclaration()) {
+
+        // parse XML declaration
+        rawToken(XMLParserHandler::DECLARATION);
+        parseXMLDeclaration();
+    }
+
+    if (isDOCTYPE()) {
+
+        // parse DOCTYPE
+        rawToken(XMLParserHandler::DOCTYPE);
+        parseDOCTYPE();
+    }
+
+    // parse content of the root element
+    parseContent(false);
+
+    content.remove_prefix(content.find_first_not_of(WHITESPACE) == content.npos ? content.size() : content.find_first_not_of(WHITESPACE));
+    while (content.size() >= "<!--"sv.size() && content[0] == '<' && isXMLComment()) {
+
+        // parse XML comment
+        rawToken(XMLParserHandler::COMMENT);
+        parseXMLComment();
+        if (content.compare(0, "-->"sv.size(), "-->"sv) != 0) {
+            parseError(XMLErrorCode::COMMENT, "parser error : Unterminated XML comment");
+        }
+        content.remove_prefix("-->"sv.size());
+        content.remove_prefix(content.find_first_not_of(WHITESPACE) == content.npos ? content.size() : content.find_first_not_of(WHITESPACE));
+    }
+
+    if (!content.empty()) {
+        parseError(XMLErrorCode::EXTRA_CONTENT, "parser error : extra content at end of document");
+    }
+    flushRaw();
+
+    // End tracing document
+    endTracing();
+    INSTRUMENTED(instrumentation.report(std::clog));
+}
+
+// get method for total bytes
+template <typename Handler>
+long long BasicXMLParser<Handler>::getTotalBytes() {
+    return totalBytes;
+}
+
+// namespace declared outside of the input, e.g., on the root of an archive for a unit fragment
+template <typename Handler>
+void BasicXMLParser<Handler>::bindNamespace(std::string_view prefix, std::string_view uri) {
+    names.bindPrefix(prefix, uri);
+}
+
+#undef HANDLES
+#undef SUBSCRIBED
+#undef TRACE
+#undef INSTRUMENTED
+#undef INSTRUMENT_HANDLER
+#undef HEADER
+#undef TRACE0
+#undef TRACE1
+#undef TRACE2
+#undef TRACE3
+#undef TRACE4
+#undef GET_TRACE
+
+#endif
@@ -9,9 +9,31 @@
 #include <iomanip>
 #include <cmath>
 #include "XMLStatsParser.hpp"
+#include "XMLParserImpl.hpp"
+
+// XML parser with direct calls to the XMLStatsParser
+template class BasicXMLParser<XMLStatsParser>;
 
 XMLStatsParser::XMLStatsParser() {}
 
+// add the counts of another handler
+void XMLStatsParser::merge(const XMLStatsParser& other) {
+
+    startDocCount += other.startDocCount;
+    XMLDeclarationCount += other.XMLDeclarationCount;
+    DOCTYPECount += other.DOCTYPECount;
+    CERCount += other.CERCount;
+    nonCERCount += other.nonCERCount;
+    commentCount += other.commentCount;
+    CDATACount += other.CDATACount;
+    PICount += other.PICount;
+    endTagCount += other.endTagCount;
+    startTagCount += other.startTagCount;
+    namespaceCount += other.namespaceCount;
+    attributeCount += other.attributeCount;
+    endDocCount += other.endDocCount;
+}
+
 void XMLStatsParser::handleStartDocument() {
 
     ++startDocCount;
@@ -27,17 +49,19 @@ void XMLStatsParser::handleDOCTYPE() {
     ++DOCTYPECount;
 }
 
-void XMLStatsParser::handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+XMLParserHandler::Directive XMLStatsParser::handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) {
 
     ++startTagCount;
+
+    return CONTINUE;
 }
 
-void XMLStatsParser::handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+void XMLStatsParser::handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) {
 
     ++endTagCount;
 }
 
-void XMLStatsParser::handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) {
+void XMLStatsParser::handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value, int nameID) {
 
     ++attributeCount;
 }
@@ -78,79 +102,79 @@ void XMLStatsParser::handleEndDocument() {
 }
 
 // Get method for startDocCount
-int XMLStatsParser::getStartDocCount(){
+long long XMLStatsParser::getStartDocCount(){
 
     return startDocCount;
 }
 
 // Get method for XMLDeclarationCount
-int XMLStatsParser::getXMLDeclarationCount(){
+long long XMLStatsParser::getXMLDeclarationCount(){
 
     return XMLDeclarationCount;
 }
 
 // Get method for DOCTYPECount
-int XMLStatsParser::getDOCTYPECount(){
+long long XMLStatsParser::getDOCTYPECount(){
 
     return DOCTYPECount;
 }
 
 // Get method for CERCount
-int XMLStatsParser::getCERCount(){
+long long XMLStatsParser::getCERCount(){
 
     return CERCount;
 }
 
 // Get method for nonCERCount
-int XMLStatsParser::getNonCERCount(){
+long long XMLStatsParser::getNonCERCount(){
 
     return nonCERCount;
 }
 
 // Get method for commentCount
-int XMLStatsParser::getCommentCount(){
+long long XMLStatsParser::getCommentCount(){
 
     return commentCount;
 }
 
 // Get method for CDATACount
-int XMLStatsParser::getCDATACount(){
+long long XMLStatsParser::getCDATACount(){
 
     return CDATACount;
 }
 
 // Get method for PICount
-int XMLStatsParser::getPICount(){
+long long XMLStatsParser::getPICount(){
 
     return PICount;
 }
 
 // Get method for endTagCount
-int XMLStatsParser::getEndTagCount(){
+long long XMLStatsParser::getEndTagCount(){
 
     return endTagCount;
 }
 
 // Get method for startTagCount
-int XMLStatsParser::getStartTagCount(){
+long long XMLStatsParser::getStartTagCount(){
 
     return startTagCount;
 }
 
 // Get method for namespaceCount
-int XMLStatsParser::getNamespaceCount(){
+long long XMLStatsParser::getNamespaceCount(){
 
     return namespaceCount;
 }
 
 // Get method for attributeCount
-int XMLStatsParser::getAttributeCount(){
+long long XMLStatsParser::getAttributeCount(){
 
     return attributeCount;
 }
 
 // Get method for endDocCount
-int XMLStatsParser::getEndDocCount(){
+long long XMLStatsParser::getEndDocCount(){
 
     return endDocCount;
 }
@@ -9,24 +9,29 @@
 #define INCLUDED_XMLSTATSPARSER_HPP
 
 #include "XMLParserHandler.hpp"
+#include "XMLParser.hpp"
 
-class XMLStatsParser : public XMLParserHandler {
+class XMLStatsParser final : public XMLParserHandler {
 
     private:
+
+    // parser calls the handler methods directly
+    template <typename Handler>
+    friend class BasicXMLParser;
     
-    int startDocCount = 0;
-    int XMLDeclarationCount = 0;
-    int DOCTYPECount = 0;
-    int CERCount = 0;
-    int nonCERCount = 0;
-    int commentCount = 0;
-    int CDATACount = 0;
-    int PICount = 0;
-    int endTagCount = 0;
-    int startTagCount = 0;
-    int namespaceCount = 0;
-    int attributeCount = 0;
-    int endDocCount = 0;
+    long long startDocCount = 0;
+    long long XMLDeclarationCount = 0;
+    long long DOCTYPECount = 0;
+    long long CERCount = 0;
+    long long nonCERCount = 0;
+    long long commentCount = 0;
+    long long CDATACount = 0;
+    long long PICount = 0;
+    long long endTagCount = 0;
+    long long startTagCount = 0;
+    long long namespaceCount = 0;
+    long long attributeCount = 0;
+    long long endDocCount = 0;
 
     // Override function for handlers
     void handleStartDocument() override;
@@ -35,11 +40,11 @@ class XMLStatsParser : public XMLParserHandler {
 
     void handleDOCTYPE() override;
 
-    void handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+    Directive handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) override;
 
-    void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+    void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) override;
 
-    void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) override;
+    void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value, int nameID) override;
 
     void handleNamespace(std::string_view prefix, std::string_view uri) override;
 
@@ -59,45 +64,51 @@ class XMLStatsParser : public XMLParserHandler {
 
     XMLStatsParser();
 
+    // Add the counts of another handler, e.g., of another file
+    void merge(const XMLStatsParser& other);
+
     // Get method for startDocCount
-    int getStartDocCount();
+    long long getStartDocCount();
 
     // Get method for XMLDeclarationCount
-    int getXMLDeclarationCount();
+    long long getXMLDeclarationCount();
 
     // Get method for DOCTYPECount
-    int getDOCTYPECount();
+    long long getDOCTYPECount();
 
     // Get method for CERCount
-    int getCERCount();
+    long long getCERCount();
 
     // Get method for nonCERCount
-    int getNonCERCount();
+    long long getNonCERCount();
 
     // Get method for commentCount
-    int getCommentCount();
+    long long getCommentCount();
 
     // Get method for CDATACount
-    int getCDATACount();
+    long long getCDATACount();
 
     // Get method for PICount
-    int getPICount();
+    long long getPICount();
 
     // Get method for endTagCount
-    int getEndTagCount();
+    long long getEndTagCount();
 
     // Get method for startTagCount
-    int getStartTagCount();
+    long long getStartTagCount();
 
     // Get method for namespaceCount
-    int getNamespaceCount();
+    long long getNamespaceCount();
 
     // Get method for attributeCount
-    int getAttributeCount();
+    long long getAttributeCount();
 
     // Get method for endDocCount
-    int getEndDocCount();
+    long long getEndDocCount();
 
 };
 
+// XML parser with direct calls to the XMLStatsParser, instantiated in XMLStatsParser.cpp
+extern template class BasicXMLParser<XMLStatsParser>;
+
 #endif
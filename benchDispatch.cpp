@@ -0,0 +1,86 @@
+/*
+    benchDispatch.cpp
+
+    Benchmark of handler dispatch, virtual calls through the XMLParserHandler
+    versus direct calls with BasicXMLParser<Handler>, for the srcFactsParser
+    and the XMLStatsParser. The srcFactsParser is also compared with its events
+    in batches. The input is parsed from memory, so the times are for parsing
+    and handling only.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+#include "MemoryInputSource.hpp"
+#include "XMLParser.hpp"
+#include "srcFactsParser.hpp"
+#include "XMLStatsParser.hpp"
+
+namespace {
+
+    // median time of parsing the input with a new handler for each run, in bytes/sec
+    template <typename Parser, typename Handler, typename... Args>
+    double bytesPerSecond(std::string_view input, int runs, Args... args) {
+
+        std::vector<double> times;
+        for (int i = 0; i < runs; ++i) {
+            Handler handler(args...);
+            MemoryInputSource inputSource(input);
+            Parser parser(handler, inputSource);
+            const auto startTime = std::chrono::steady_clock::now();
+            parser.parse();
+            const auto finishTime = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count());
+        }
+        std::sort(times.begin(), times.end());
+
+        return static_cast<double>(input.size()) / times[times.size() / 2];
+    }
+
+    // compare virtual and direct handler calls
+    template <typename Handler, typename... Args>
+    void compare(std::string_view title, std::string_view input, int runs, Args... args) {
+
+        const double virtualSpeed = bytesPerSecond<XMLParser, Handler>(input, runs, args...);
+        const double directSpeed = bytesPerSecond<BasicXMLParser<Handler>, Handler>(input, runs, args...);
+
+        std::cout << "| " << std::setw(14) << std::left << title << std::right
+                  << " | " << std::setw(12) << virtualSpeed / 1e6
+                  << " | " << std::setw(11) << directSpeed / 1e6
+                  << " | " << std::setw(7) << directSpeed / virtualSpeed << "x |\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    if (argc < 2) {
+        std::cerr << "usage: bench_dispatch file.xml [runs]\n";
+        return 1;
+    }
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file) {
+        std::cerr << "benchDispatch: Unable to open " << argv[1] << '\n';
+        return 1;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    const std::string input = contents.str();
+    const int runs = argc > 2 ? std::max(1, atoi(argv[2])) : 11;
+
+    std::cout << "# Handler dispatch: " << input.size() << " bytes, median of " << runs << " runs\n";
+    std::cout << "| Handler        | Virtual MB/s | Direct MB/s | Speedup |\n";
+    std::cout << "|:---------------|-------------:|------------:|--------:|\n";
+    std::cout.precision(3);
+    compare<srcFactsParser>("srcFactsParser", input, runs);
+    compare<srcFactsParser>("srcFacts batch", input, runs, true);
+    compare<XMLStatsParser>("XMLStatsParser", input, runs);
+
+    return 0;
+}
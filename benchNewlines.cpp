@@ -0,0 +1,114 @@
+/*
+    benchNewlines.cpp
+
+    Micro-benchmark of newline counting, std::count() versus countNewlines().
+    The characters are the character content of an XML file, or synthetic text.
+    Both the entire text and the individual runs of text between markup
+    are counted, as the parser passes runs to the handler.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+#include "scanCharacters.hpp"
+
+namespace {
+
+    // time the count of all runs, repeated, in bytes/sec
+    template <typename Count>
+    double bytesPerSecond(const std::vector<std::string_view>& runs, std::size_t totalSize, int repeat, Count count, std::size_t& newlines) {
+
+        const auto startTime = std::chrono::steady_clock::now();
+        std::size_t total = 0;
+        for (int i = 0; i < repeat; ++i) {
+            for (const auto run : runs)
+                total += count(run);
+        }
+        const auto finishTime = std::chrono::steady_clock::now();
+        const auto elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count();
+        newlines = total / repeat;
+
+        return static_cast<double>(totalSize) * repeat / elapsedSeconds;
+    }
+
+    // compare both counts for the runs
+    void compare(std::string_view title, const std::vector<std::string_view>& runs, int repeat) {
+
+        std::size_t totalSize = 0;
+        for (const auto run : runs)
+            totalSize += run.size();
+
+        std::size_t stdNewlines = 0;
+        const double stdSpeed = bytesPerSecond(runs, totalSize, repeat, [](std::string_view run) {
+            return static_cast<std::size_t>(std::count(run.cbegin(), run.cend(), '\n'));
+        }, stdNewlines);
+
+        std::size_t simdNewlines = 0;
+        const double simdSpeed = bytesPerSecond(runs, totalSize, repeat, [](std::string_view run) {
+            return countNewlines(run);
+        }, simdNewlines);
+
+        std::cout << "| " << std::setw(14) << std::left << title << std::right
+                  << " | " << std::setw(8) << runs.size()
+                  << " | " << std::setw(10) << stdSpeed / 1e9
+                  << " | " << std::setw(10) << simdSpeed / 1e9
+                  << " | " << std::setw(7) << simdSpeed / stdSpeed << "x"
+                  << " | " << (stdNewlines == simdNewlines ? "yes" : "NO") << " |\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    // input file, or synthetic text of short lines
+    std::string input;
+    if (argc > 1) {
+        std::ifstream file(argv[1], std::ios::binary);
+        if (!file) {
+            std::cerr << "benchNewlines: Unable to open " << argv[1] << '\n';
+            return 1;
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        input = contents.str();
+    } else {
+        for (int i = 0; input.size() < 16 * 1024 * 1024; ++i) {
+            input += std::string(i % 61, 'x');
+            input += i % 7 ? ' ' : '\n';
+        }
+    }
+
+    // runs of character content between markup
+    std::vector<std::string_view> runs;
+    const std::string_view text(input);
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        const std::size_t markupStart = text.find_first_of("<&", pos);
+        if (markupStart != pos)
+            runs.push_back(text.substr(pos, markupStart - pos));
+        if (markupStart == text.npos)
+            break;
+        pos = text.find_first_of(";>", markupStart);
+        if (pos == text.npos)
+            break;
+        ++pos;
+    }
+
+    // repeat small inputs for a measurable time
+    const int repeat = std::max<std::size_t>(1, (256 * 1024 * 1024) / std::max<std::size_t>(1, input.size()));
+
+    std::cout << "# countNewlines: " << scanInstructionSet() << '\n';
+    std::cout << "| Characters     |     Runs | std (GB/s) | new (GB/s) | Speedup | Same |\n";
+    std::cout << "|:---------------|---------:|-----------:|-----------:|--------:|:----:|\n";
+    std::cout.precision(3);
+    compare("Entire text", { text }, repeat);
+    compare("Runs", runs, repeat);
+
+    return 0;
+}
@@ -0,0 +1,187 @@
+/*
+    benchParser.cpp
+
+    Benchmark of the XML parser with each of the handlers, srcFactsParser,
+    also with the structural index tokenizer, XMLStatsParser, and
+    identityParser, with and without passthrough, on a synthetic srcML archive.
+    A selective handler that only counts functions, and their lines, is run both
+    with the content of each function parsed and skipped.
+    The input is parsed from memory, so the times are for parsing and handling only.
+    The output of the identityParser goes to the null device.
+
+    The shape of the srcML is set with options, e.g.:
+
+        bench_parser --units 400 --depth 6 --attributes 0.5 --entities 0.2
+
+    With --generate, the srcML is written to standard output instead.
+*/
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+#include <fcntl.h>
+
+#if !defined(_MSC_VER)
+#include <unistd.h>
+#define CLOSE close
+#define NULL_DEVICE "/dev/null"
+#else
+#include <io.h>
+#define CLOSE _close
+#define NULL_DEVICE "NUL"
+#endif
+
+#include "generateSrcML.hpp"
+#include "MemoryInputSource.hpp"
+#include "XMLParser.hpp"
+#include "srcFactsParser.hpp"
+#include "XMLStatsParser.hpp"
+#include "identityParser.hpp"
+#include "XMLParserImpl.hpp"
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // count of the functions and their lines, with the content of each function parsed or skipped
+    class functionParser final : public XMLParserHandler {
+
+        public:
+
+        explicit functionParser(bool skip = false) : skip(skip) {}
+
+        Directive handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) override {
+
+            if (nameID != NameTable::FUNCTION)
+                return CONTINUE;
+            ++functionCount;
+            return skip ? SKIP : CONTINUE;
+        }
+
+        void handleCharacterNonEntityReferences(std::string_view characters) override {
+
+            loc += static_cast<long long>(countNewlines(characters));
+        }
+
+        void handleSkipped(long long bytes, long long newlines) override {
+
+            loc += newlines;
+        }
+
+        private:
+
+        bool skip;
+        long long functionCount = 0;
+        long long loc = 0;
+    };
+
+    // time of one parse of the input with a new handler
+    template <typename Parser, typename Handler, typename... Args>
+    double parseSeconds(std::string_view input, Tokenizer tokenizer, Args... args) {
+
+        Handler handler(args...);
+        MemoryInputSource inputSource(input);
+        Parser parser(handler, inputSource, tokenizer);
+        const auto startTime = std::chrono::steady_clock::now();
+        parser.parse();
+        const auto finishTime = std::chrono::steady_clock::now();
+
+        return std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count();
+    }
+
+    // median and best throughput of the runs
+    template <typename Parser, typename Handler, typename... Args>
+    void bench(std::string_view title, std::string_view input, int runs, Tokenizer tokenizer, Args... args) {
+
+        std::vector<double> times;
+        for (int i = 0; i < runs; ++i)
+            times.push_back(parseSeconds<Parser, Handler>(input, tokenizer, args...));
+        std::sort(times.begin(), times.end());
+
+        const double size = static_cast<double>(input.size());
+        std::cout << "| " << std::setw(14) << std::left << title << std::right
+                  << " | " << std::setw(11) << size / times[times.size() / 2] / 1e6
+                  << " | " << std::setw(9) << size / times.front() / 1e6 << " |\n";
+    }
+
+    // usage of the benchmark
+    int usage() {
+
+        std::cerr << "usage: bench_parser [--units n] [--depth n] [--attributes density] [--comments ratio]\n"
+                     "                    [--cdata ratio] [--entities frequency] [--seed n] [--runs n] [--generate]\n";
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    SrcMLOptions options;
+    int runs = 11;
+    bool generateOnly = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (arg == "--generate"sv) {
+            generateOnly = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            return usage();
+        const char* value = argv[++i];
+        if (arg == "--units"sv)
+            options.units = std::max(0, atoi(value));
+        else if (arg == "--depth"sv)
+            options.depth = std::max(0, atoi(value));
+        else if (arg == "--attributes"sv)
+            options.attributeDensity = std::max(0.0, atof(value));
+        else if (arg == "--comments"sv)
+            options.commentRatio = std::max(0.0, atof(value));
+        else if (arg == "--cdata"sv)
+            options.cdataRatio = std::max(0.0, atof(value));
+        else if (arg == "--entities"sv)
+            options.entityFrequency = std::max(0.0, atof(value));
+        else if (arg == "--seed"sv)
+            options.seed = strtoull(value, nullptr, 10);
+        else if (arg == "--runs"sv)
+            runs = std::max(1, atoi(value));
+        else
+            return usage();
+    }
+
+    const std::string input = generateSrcML(options);
+    if (generateOnly) {
+        std::cout << input;
+        return 0;
+    }
+
+    std::cout << "# XMLParser: " << input.size() << " bytes of synthetic srcML, median of " << runs << " runs\n";
+    std::cout << "units " << options.units << ", depth " << options.depth
+              << ", attributes " << options.attributeDensity << ", comments " << options.commentRatio
+              << ", CDATA " << options.cdataRatio << ", entities " << options.entityFrequency
+              << ", seed " << options.seed << "\n\n";
+    std::cout << "| Handler        | Median MB/s | Best MB/s |\n";
+    std::cout << "|:---------------|------------:|----------:|\n";
+    std::cout << std::fixed << std::setprecision(1);
+    bench<BasicXMLParser<srcFactsParser>, srcFactsParser>("srcFactsParser", input, runs, Tokenizer::SCAN);
+    bench<BasicXMLParser<srcFactsParser>, srcFactsParser>("srcFacts index", input, runs, Tokenizer::INDEX);
+    bench<BasicXMLParser<XMLStatsParser>, XMLStatsParser>("XMLStatsParser", input, runs, Tokenizer::SCAN);
+    bench<BasicXMLParser<functionParser>, functionParser>("functions", input, runs, Tokenizer::SCAN, false);
+    bench<BasicXMLParser<functionParser>, functionParser>("functions skip", input, runs, Tokenizer::SCAN, true);
+
+    // identity output to the null device, to time the output without storing it
+    const int nullFD = open(NULL_DEVICE, O_WRONLY);
+    if (nullFD == -1) {
+        std::cerr << "bench_parser: Unable to open " << NULL_DEVICE << '\n';
+        return 1;
+    }
+    bench<XMLParser, identityParser>("identityParser", input, runs, Tokenizer::SCAN, nullFD);
+    bench<XMLParser, identityParser>("identity -p", input, runs, Tokenizer::SCAN, nullFD, true);
+    CLOSE(nullFD);
+
+    return 0;
+}
@@ -0,0 +1,230 @@
+/*
+    checkServer.cpp
+
+    Check of the srcFacts server with truncated documents. The server runs
+    on a thread of the check, and one connection sends a DATA request for
+    each prefix of the document, e.g., one that ends inside the XML declaration.
+    Each request must have an OK or ERROR reply on the same connection, and
+    the whole document, sent again at the end, an OK reply.
+
+    The document is a small srcML archive, or the file on the command line:
+
+        check_server data/demo.xml
+
+    For a file, each prefix up to 4096 bytes, and after that one of each
+    stride bytes, is sent, so a large file is checked in a reasonable time.
+*/
+
+#include <iostream>
+
+#if !defined(_MSC_VER)
+
+#include "srcFactsServer.hpp"
+
+#include <string>
+#include <string_view>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // document with each kind of token, with the truncations of each checked
+    constexpr std::string_view DOCUMENT = R"(<?xml version="1.0" encoding="UTF-8" standalone="yes"?>
+<!DOCTYPE unit>
+<unit xmlns="http://www.srcML.org/srcML/src" xmlns:cpp="http://www.srcML.org/srcML/cpp" revision="1.0.0">
+
+<unit revision="1.0.0" language="C++" filename="a.cpp"><cpp:include>#<cpp:directive>include</cpp:directive> <cpp:file>&lt;iostream&gt;</cpp:file></cpp:include>
+<comment type="line">// a &amp; b</comment>
+<function><type><name>int</name></type> <name>main</name><parameter_list>()</parameter_list> <block>{<block_content>
+    <return>return <expr><literal type="number">0</literal></expr>;</return>
+</block_content>}</block></function>
+</unit>
+
+<unit revision="1.0.0" language="Java" filename="b.java"><?pi data?><name>a<![CDATA[<b>&]]>c</name ><empty/>
+</unit>
+
+</unit>
+<!-- end -->
+)";
+
+    // prefixes up to this length are all sent for a file
+    constexpr std::size_t ALL_PREFIXES = 4096;
+
+    // client connection to the server
+    class Client {
+
+        public:
+
+        explicit Client(int fd) : fd(fd) {}
+
+        Client(const Client&) = delete;
+
+        Client& operator=(const Client&) = delete;
+
+        ~Client() {
+
+            close(fd);
+        }
+
+        // send a DATA request with the document, false when the connection is closed
+        [[nodiscard]] bool sendData(std::string_view document) {
+
+            const std::string command = "DATA " + std::to_string(document.size()) + "\n";
+            return writeAll(command) && writeAll(document);
+        }
+
+        // status of the reply, with its body read, empty when the connection is closed
+        [[nodiscard]] std::string readReply(std::string& body) {
+
+            std::string status;
+            char c = 0;
+            while (readAll(&c, 1) && c != '\n')
+                status += c;
+            if (c != '\n')
+                return std::string();
+            const auto space = status.find(' ');
+            if (space == std::string::npos)
+                return std::string();
+            body.resize(std::stoul(status.substr(space + 1)));
+            if (!readAll(body.data(), body.size()))
+                return std::string();
+
+            return status.substr(0, space);
+        }
+
+        private:
+
+        // write all the data, continuing after partial writes and interrupts
+        [[nodiscard]] bool writeAll(std::string_view data) {
+
+            while (!data.empty()) {
+                const ssize_t bytesWritten = write(fd, data.data(), data.size());
+                if (bytesWritten == -1 && errno == EINTR)
+                    continue;
+                if (bytesWritten <= 0)
+                    return false;
+                data.remove_prefix(static_cast<std::size_t>(bytesWritten));
+            }
+
+            return true;
+        }
+
+        // read all of the size, false at the end of the input
+        [[nodiscard]] bool readAll(char* data, std::size_t size) {
+
+            while (size > 0) {
+                const ssize_t bytesRead = read(fd, data, size);
+                if (bytesRead == -1 && errno == EINTR)
+                    continue;
+                if (bytesRead <= 0)
+                    return false;
+                data += bytesRead;
+                size -= static_cast<std::size_t>(bytesRead);
+            }
+
+            return true;
+        }
+
+        int fd;
+    };
+
+    // connect to the server, waiting for it to listen, -1 if it does not
+    [[nodiscard]] int connectServer(const sockaddr_un& address) {
+
+        for (int attempt = 0; attempt < 100; ++attempt) {
+            const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd == -1)
+                return -1;
+            if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0)
+                return fd;
+            close(fd);
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+
+        return -1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    // document of the command line, or the archive of each kind of token
+    std::string document(DOCUMENT);
+    if (argc > 1) {
+        std::ifstream file(argv[1], std::ios::binary);
+        if (!file) {
+            std::cerr << "check_server error : Unable to open file '" << argv[1] << "'\n";
+            return 1;
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        document = contents.str();
+    }
+    const std::size_t stride = std::max<std::size_t>(document.size() / 1000, 1);
+
+    // server on a thread, stopped with the process
+    const std::string socketPath = "/tmp/check_server." + std::to_string(getpid()) + ".sock";
+    std::thread([&socketPath]() { (void) srcFactsServer(socketPath.c_str(), 1); }).detach();
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, socketPath.c_str());
+    const int fd = connectServer(address);
+    if (fd == -1) {
+        std::cerr << "check_server error : Unable to connect to the server on '" << socketPath << "'\n";
+        return 1;
+    }
+    Client client(fd);
+
+    // each prefix has a reply on the same connection, so the server has not stopped
+    long long okCount = 0;
+    long long errorCount = 0;
+    std::string body;
+    for (std::size_t length = 0; length < document.size(); length += length < ALL_PREFIXES ? 1 : stride) {
+        if (!client.sendData(std::string_view(document).substr(0, length))) {
+            std::cerr << "check_server error : Connection closed sending prefix of " << length << " bytes\n";
+            unlink(socketPath.c_str());
+            return 1;
+        }
+        const std::string status = client.readReply(body);
+        if (status == "OK"sv) {
+            ++okCount;
+        } else if (status == "ERROR"sv) {
+            ++errorCount;
+        } else {
+            std::cerr << "check_server error : No reply for prefix of " << length << " bytes\n";
+            unlink(socketPath.c_str());
+            return 1;
+        }
+    }
+
+    // whole document
+    const bool whole = client.sendData(document) && client.readReply(body) == "OK"sv;
+    unlink(socketPath.c_str());
+    if (!whole) {
+        std::cerr << "check_server error : Whole document without an OK reply\n" << body << '\n';
+        return 1;
+    }
+    std::cout << okCount + errorCount << " prefixes, " << errorCount << " ERROR, " << okCount << " OK, whole document OK\n";
+
+    return 0;
+}
+
+#else
+
+int main() {
+
+    std::cerr << "check_server error : The server is not available on Windows\n";
+    return 1;
+}
+
+#endif
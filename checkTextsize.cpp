@@ -0,0 +1,174 @@
+/*
+    checkTextsize.cpp
+
+    Check of the 64-bit counts of the srcFactsParser with more than 2^31 characters.
+    A synthetic srcML archive is generated, and its units are repeated by an input
+    source until the archive has more characters than an int holds, so there is no
+    large file or buffer. The counts of the archive are compared with the counts
+    expected from parses of the archive with no repeats and with one.
+
+    The number of characters is set with an option, e.g.:
+
+        check_textsize --characters 3000000000
+*/
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#include "generateSrcML.hpp"
+#include "InputSource.hpp"
+#include "XMLParser.hpp"
+#include "srcFactsParser.hpp"
+#include "XMLParserImpl.hpp"
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // input of an archive with its nested units repeated, one repeat of the units for each refill
+    class RepeatedUnitsInputSource : public InputSource {
+
+        public:
+
+        /*
+            Constructor
+
+            @param head Start of the archive, up to the first nested unit
+            @param units Nested units of the archive
+            @param tail End of the archive, after the last nested unit
+            @param repeats Number of repeats of the units
+        */
+        RepeatedUnitsInputSource(std::string_view head, std::string_view units, std::string_view tail, long long repeats)
+            : head(head), units(units), tail(tail), repeats(repeats) {}
+
+        // refill the content preserving the existing data, followed by the next part of the archive
+        [[nodiscard]] long refill(std::string_view& content) override {
+
+            std::string_view part;
+            if (!headDone) {
+                part = head;
+                headDone = true;
+            } else if (repeated < repeats) {
+                part = units;
+                ++repeated;
+            } else if (!tailDone) {
+                part = tail;
+                tailDone = true;
+            } else {
+                return 0;
+            }
+
+            // the content is in the current buffer, so it is copied to the other one
+            next.assign(content.data(), content.size());
+            next.append(part);
+            buffer.swap(next);
+            content = buffer;
+
+            return static_cast<long>(part.size());
+        }
+
+        [[nodiscard]] std::string_view mode() const override {
+
+            return "generated"sv;
+        }
+
+        private:
+
+        std::string_view head;
+        std::string_view units;
+        std::string_view tail;
+        long long repeats;
+        long long repeated = 0;
+        bool headDone = false;
+        bool tailDone = false;
+        std::string buffer;
+        std::string next;
+    };
+
+    // counts of the archive with the units repeated
+    struct Counts {
+        long long characters = 0;
+        long long loc = 0;
+        long long functions = 0;
+        long long totalBytes = 0;
+    };
+
+    // parse the archive with the units repeated
+    Counts parseRepeated(std::string_view head, std::string_view units, std::string_view tail, long long repeats) {
+
+        srcFactsParser handler;
+        RepeatedUnitsInputSource input(head, units, tail, repeats);
+        BasicXMLParser<srcFactsParser> parser(handler, input);
+        if (const auto error = parser.parse()) {
+            std::cerr << "check_textsize error : " << error.message << '\n';
+            std::exit(1);
+        }
+
+        return { handler.getTextsize(), handler.getLOC(), handler.getFunctionCount(), parser.getTotalBytes() };
+    }
+
+    // check a count against its expected value
+    bool check(std::string_view name, long long value, long long expected) {
+
+        std::cout << "| " << name << " | " << value << " | " << expected << " |\n";
+        if (value == expected)
+            return true;
+        std::cerr << "check_textsize error : " << name << " is " << value << ", expected " << expected << '\n';
+        return false;
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    // characters past the maximum of an int, by default
+    long long minimumCharacters = (1LL << 31) + (1LL << 27);
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (arg == "--characters"sv && i + 1 < argc) {
+            minimumCharacters = std::max(1LL, std::strtoll(argv[++i], nullptr, 10));
+        } else {
+            std::cerr << "usage: check_textsize [--characters n]\n";
+            return 1;
+        }
+    }
+
+    // archive split into the part before the nested units, the units, and the part after
+    SrcMLOptions options;
+    const std::string archive = generateSrcML(options);
+    const std::size_t unitsStart = archive.find("<unit", archive.find("<unit") + 1);
+    const std::size_t unitsEnd = archive.rfind("</unit>");
+    if (unitsStart == archive.npos || unitsEnd == archive.npos || unitsEnd < unitsStart) {
+        std::cerr << "check_textsize error : Generated archive without nested units\n";
+        return 1;
+    }
+    const std::string_view head(std::string_view(archive).substr(0, unitsStart));
+    const std::string_view units(std::string_view(archive).substr(unitsStart, unitsEnd - unitsStart));
+    const std::string_view tail(std::string_view(archive).substr(unitsEnd));
+
+    // counts of the units from the archive with no repeats and with one
+    const Counts none = parseRepeated(head, units, tail, 0);
+    const Counts once = parseRepeated(head, units, tail, 1);
+    const long long unitCharacters = once.characters - none.characters;
+    const long long repeats = (minimumCharacters - none.characters + unitCharacters - 1) / unitCharacters;
+
+    const auto startTime = std::chrono::steady_clock::now();
+    const Counts counts = parseRepeated(head, units, tail, repeats);
+    const auto finishTime = std::chrono::steady_clock::now();
+    const auto elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count();
+
+    std::cout << "# srcFactsParser: " << repeats << " repeats of " << units.size() << " bytes of units, "
+              << elapsedSeconds << " sec\n";
+    std::cout << "| Measure | Value | Expected |\n";
+    std::cout << "|:--|--:|--:|\n";
+    bool passed = check("Characters"sv, counts.characters, none.characters + repeats * unitCharacters);
+    passed = check("LOC"sv, counts.loc, none.loc + repeats * (once.loc - none.loc)) && passed;
+    passed = check("Functions"sv, counts.functions, none.functions + repeats * (once.functions - none.functions)) && passed;
+    passed = check("Bytes"sv, counts.totalBytes, static_cast<long long>(head.size() + tail.size()) + repeats * static_cast<long long>(units.size())) && passed;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+/*
+    generateSrcML.cpp
+
+    Implementation file for generating synthetic srcML archives for benchmarks
+*/
+
+#include "generateSrcML.hpp"
+#include <string_view>
+#include <array>
+#include <cstdint>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // element names of statements and of nested elements
+    constexpr std::array STATEMENTS = { "decl_stmt"sv, "expr_stmt"sv, "return"sv, "if_stmt"sv, "while"sv, "for"sv, "function"sv, "class"sv, "comment"sv };
+    constexpr std::array ELEMENTS = { "expr"sv, "name"sv, "decl"sv, "type"sv, "init"sv, "call"sv, "argument_list"sv, "argument"sv,
+                                      "operator"sv, "literal"sv, "block"sv, "condition"sv, "specifier"sv, "cpp:define"sv };
+    constexpr std::array TYPES = { "line"sv, "block"sv, "string"sv, "number"sv, "char"sv, "generic"sv, "pointer"sv };
+    constexpr std::array TOKENS = { "x"sv, "count"sv, "i"sv, " = "sv, " + "sv, "value"sv, "1"sv, "0x10"sv, "data"sv, ", "sv, "size"sv, "std"sv, "::"sv };
+    constexpr std::array ENTITIES = { "&lt;"sv, "&gt;"sv, "&amp;"sv };
+
+    // splitmix64, as the standard distributions differ between implementations
+    class Random {
+        public:
+
+        explicit Random(std::uint64_t seed) : state(seed) {}
+
+        // next random value
+        std::uint64_t next() {
+
+            std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        // random value in [0, n)
+        std::size_t below(std::size_t n) {
+
+            return static_cast<std::size_t>(next() % n);
+        }
+
+        // random value in [0, 1)
+        double fraction() {
+
+            return static_cast<double>(next() >> 11) / 9007199254740992.0;
+        }
+
+        // random event with the probability
+        bool chance(double probability) {
+
+            return fraction() < probability;
+        }
+
+        // random item of the array
+        template <typename Array>
+        auto pick(const Array& items) {
+
+            return items[below(items.size())];
+        }
+
+        private:
+
+        std::uint64_t state;
+    };
+
+    // generator for one srcML archive
+    class Generator {
+        public:
+
+        Generator(const SrcMLOptions& options, std::string& srcML)
+            : options(options), srcML(srcML), random(options.seed) {}
+
+        // generate the archive
+        void archive() {
+
+            srcML += "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"sv;
+            srcML += "<unit xmlns=\"http://www.srcML.org/srcML/src\" xmlns:cpp=\"http://www.srcML.org/srcML/cpp\" revision=\"1.0.0\" url=\"synthetic\">\n\n"sv;
+            for (int i = 0; i < options.units; ++i)
+                unit(i);
+            srcML += "</unit>\n"sv;
+        }
+
+        private:
+
+        // generate a unit with a sequence of statements
+        void unit(int number) {
+
+            srcML += "<unit revision=\"1.0.0\" language=\"C++\" filename=\"src/file"sv;
+            srcML += std::to_string(number);
+            srcML += ".cpp\">"sv;
+            const std::size_t statements = 20 + random.below(40);
+            for (std::size_t i = 0; i < statements; ++i) {
+                element(random.pick(STATEMENTS), 0);
+                srcML += '\n';
+            }
+            srcML += "</unit>\n\n"sv;
+        }
+
+        // generate an element with nested elements and text
+        void element(std::string_view name, int level) {
+
+            srcML += '<';
+            srcML += name;
+
+            // attributes, the whole part of the density plus the fraction as a chance
+            int attributes = static_cast<int>(options.attributeDensity);
+            if (random.chance(options.attributeDensity - attributes))
+                ++attributes;
+            for (int i = 0; i < attributes; ++i) {
+                srcML += i == 0 ? " type=\""sv : " ref=\""sv;
+                srcML += random.pick(TYPES);
+                srcML += '"';
+            }
+            srcML += '>';
+
+            // content, with the number of children decreasing with the level
+            const std::size_t children = level < options.depth ? random.below(4) : 0;
+            for (std::size_t i = 0; i < children; ++i) {
+                if (random.chance(options.commentRatio)) {
+                    srcML += "<!-- "sv;
+                    text(3);
+                    srcML += " -->"sv;
+                } else if (random.chance(options.cdataRatio)) {
+                    srcML += "<![CDATA["sv;
+                    text(3);
+                    srcML += "]]>"sv;
+                } else {
+                    element(random.pick(ELEMENTS), level + 1);
+                }
+                text(1 + random.below(2));
+            }
+            if (children == 0)
+                text(1 + random.below(3));
+
+            srcML += "</"sv;
+            srcML += name;
+            srcML += '>';
+        }
+
+        // generate text tokens with entity references
+        void text(std::size_t tokens) {
+
+            for (std::size_t i = 0; i < tokens; ++i) {
+                if (random.chance(options.entityFrequency))
+                    srcML += random.pick(ENTITIES);
+                else
+                    srcML += random.pick(TOKENS);
+            }
+            if (random.chance(0.1))
+                srcML += "\n    "sv;
+        }
+
+        const SrcMLOptions& options;
+        std::string& srcML;
+        Random random;
+    };
+}
+
+/*
+    Generate a synthetic srcML archive.
+
+    The output is deterministic for the options on any platform,
+    so benchmark results are comparable between machines and runs.
+
+    @param options Shape of the generated srcML
+    @return srcML archive
+*/
+[[nodiscard]] std::string generateSrcML(const SrcMLOptions& options) {
+
+    std::string srcML;
+    Generator(options, srcML).archive();
+
+    return srcML;
+}
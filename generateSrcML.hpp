@@ -0,0 +1,48 @@
+/*
+    generateSrcML.hpp
+
+    Include file for generating synthetic srcML archives for benchmarks
+*/
+
+#ifndef INCLUDED_GENERATESRCML_HPP
+#define INCLUDED_GENERATESRCML_HPP
+
+#include <string>
+
+// shape of the generated srcML
+struct SrcMLOptions {
+
+    // number of nested units in the archive
+    int units = 200;
+
+    // maximum nesting depth of the elements in a unit, below the statements
+    int depth = 8;
+
+    // average number of attributes per element
+    double attributeDensity = 0.3;
+
+    // fraction of the markup that is XML comments
+    double commentRatio = 0.02;
+
+    // fraction of the markup that is CDATA sections
+    double cdataRatio = 0.01;
+
+    // fraction of the text tokens that are entity references, i.e., &lt; &gt; &amp;
+    double entityFrequency = 0.05;
+
+    // seed of the generator, the same seed and options give the same srcML
+    unsigned long long seed = 1;
+};
+
+/*
+    Generate a synthetic srcML archive.
+
+    The output is deterministic for the options on any platform,
+    so benchmark results are comparable between machines and runs.
+
+    @param options Shape of the generated srcML
+    @return srcML archive
+*/
+[[nodiscard]] std::string generateSrcML(const SrcMLOptions& options);
+
+#endif
@@ -5,6 +5,13 @@
     The output XML is the same (as much as possible) as the input XML.
 
     There are no CDATA parts, but escape all >, <, and & in Character and CDATA content.
+
+    With --passthrough, the unchanged markup and characters are copied as is,
+    and only CDATA is rewritten.
+
+    Reads standard input, or the files and glob patterns of the command line.
+    The files are transformed in parallel, each into a temporary file, and
+    output in the order of the command line.
 */
 
 #include <iostream>
@@ -12,16 +19,117 @@
 #include <string>
 #include <string_view>
 #include <optional>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
 
+#include "InputSource.hpp"
 #include "XMLParser.hpp"
 #include "identityParser.hpp"
+#include "inputFiles.hpp"
+
+#if defined(_MSC_VER)
+#define fileno _fileno
+#endif
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // transformed output of an input file
+    struct FileOutput {
+        std::FILE* output = nullptr;
+        XMLParseError error;
+    };
+
+    // copy the file from the start to standard output
+    void copyOutput(std::FILE* output) {
+
+        std::rewind(output);
+        char buffer[64 * 1024];
+        std::size_t bytesRead = 0;
+        while ((bytesRead = std::fread(buffer, 1, sizeof(buffer), output)) > 0)
+            std::fwrite(buffer, 1, bytesRead, stdout);
+    }
+}
 
 int main(int argc, char* argv[]) {
 
-    identityParser handler;
-    XMLParser parser(handler);
-    
-    parser.parse();
+    bool passthrough = false;
+    // number of worker threads for the input files, with 0 for all cores
+    int jobs = 1;
+    // input files and glob patterns, with standard input if none
+    std::vector<std::string_view> inputArguments;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (arg == "--passthrough"sv || arg == "-p"sv) {
+            passthrough = true;
+        } else if ((arg == "-j"sv || arg == "--jobs"sv) && i + 1 < argc) {
+            jobs = atoi(argv[++i]);
+        } else if (!arg.empty() && arg[0] != '-') {
+            inputArguments.push_back(arg);
+        } else {
+            std::cerr << "usage: identity [--passthrough] [-j jobs] [file.xml ...] < file.xml\n";
+            return 1;
+        }
+    }
+    if (jobs < 1)
+        jobs = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    if (inputArguments.empty()) {
+        identityParser handler(1, passthrough);
+        auto input = makeInputSource();
+        XMLParser parser(handler, *input);
+
+        if (const auto error = parser.parse()) {
+            std::cerr << error.message << '\n';
+            return 1;
+        }
+
+        return 0;
+    }
+
+    std::vector<std::string> paths;
+    std::string unmatched;
+    if (!expandInputFiles(inputArguments, paths, unmatched)) {
+        std::cerr << "identity error : No files match '" << unmatched << "'\n";
+        return 1;
+    }
+
+    // each file is transformed by one worker with its own parser, into a temporary file
+    std::vector<FileOutput> files(paths.size());
+    parallelFor(files.size(), jobs, [&](std::size_t i) {
+        FileOutput& file = files[i];
+        auto input = makeInputSource(paths[i].c_str());
+        file.output = std::tmpfile();
+        if (!input || !file.output) {
+            file.error.code = XMLErrorCode::INPUT;
+            file.error.message = !input ? "identity error : Unable to open file" : "identity error : Unable to create temporary file";
+            return;
+        }
+
+        // output is written when the handler is destroyed
+        identityParser handler(fileno(file.output), passthrough);
+        XMLParser parser(handler, *input);
+        file.error = parser.parse();
+    });
+
+    // output of each file, in the order of the command line
+    int failedFiles = 0;
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        if (files[i].error) {
+            std::cerr << paths[i] << ": " << files[i].error.message << '\n';
+            ++failedFiles;
+        } else {
+            copyOutput(files[i].output);
+        }
+        if (files[i].output)
+            std::fclose(files[i].output);
+    }
+    std::fflush(stdout);
 
-    return 0;
+    return failedFiles ? 1 : 0;
 }
@@ -7,8 +7,6 @@
     There are no CDATA parts, but escape all >, <, and & in Character and CDATA content.
 */
 
-#include <iostream>
-#include <fstream>
 #include <string>
 #include <string_view>
 #include <optional>
@@ -17,94 +15,142 @@
 
 using namespace std::literals::string_view_literals;
 
-identityParser::identityParser() {}
+identityParser::identityParser(int fd, bool passthrough) : output(fd), passthrough(passthrough) {}
+
+unsigned int identityParser::events() const {
+
+    if (passthrough)
+        return RAW | CDATA | END_DOCUMENT;
+
+    return ALL_EVENTS;
+}
 
 void identityParser::handleStartDocument() {}
 
 void identityParser::handleDeclaration(std::string_view version, std::optional<std::string_view> encoding, std::optional<std::string_view> standalone) {
 
-    std::cout << "<?xml version=\"" << version << "\" encoding=\"" << encoding.value() << "\" standalone=\"" << standalone.value() << "\"?>\n";
+    output.write("<?xml version=\""sv);
+    output.write(version);
+    output.write("\" encoding=\""sv);
+    output.write(encoding.value());
+    output.write("\" standalone=\""sv);
+    output.write(standalone.value());
+    output.write("\"?>\n"sv);
 }
 
 void identityParser::handleDOCTYPE() {}
 
-void identityParser::handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+XMLParserHandler::Directive identityParser::handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) {
 
-    std::cout << "<" << qName << ">";
+    closeStartTag();
+    output.write('<');
+    output.write(qName);
+    inStartTag = true;
+
+    return CONTINUE;
 }
 
-void identityParser::handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+void identityParser::handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) {
 
-    std::cout << "</" << qName << ">";
+    closeStartTag();
+    output.write("</"sv);
+    output.write(qName);
+    output.write('>');
 }
 
-void identityParser::handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) {
+void identityParser::handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value, int nameID) {
 
-    std::cout.seekp(-1, std::ios::cur);
-    std::cout << " " << qName << "=\"" << value << "\">";
+    output.write(' ');
+    output.write(qName);
+    output.write("=\""sv);
+    output.write(value);
+    output.write('"');
 }
 
 void identityParser::handleNamespace(std::string_view prefix, std::string_view uri) {
-    
-    std::cout.seekp(-1, std::ios::cur);
-    if(prefix.empty())
-        std::cout << " xmlns=\"" << uri << "\">";
-    else
-        std::cout << " xmlns:" << prefix << "=\"" << uri << "\">";
+
+    if (prefix.empty()) {
+        output.write(" xmlns=\""sv);
+    } else {
+        output.write(" xmlns:"sv);
+        output.write(prefix);
+        output.write("=\""sv);
+    }
+    output.write(uri);
+    output.write('"');
 }
 
 void identityParser::handleComment(std::string_view comment) {
 
-    std::cout << "<!--" << comment << "-->";
+    closeStartTag();
+    output.write("<!--"sv);
+    output.write(comment);
+    output.write("-->"sv);
 }
 
-
 void identityParser::handleCDATA(std::string_view characters) {
 
-    if(characters == "<") {
-            std::cout << "&lt;";
-        } else if(characters == "&") {
-            std::cout << "&amp;";
-        } else if(characters == ">") {
-            std::cout << "&gt;";
-        } else {
-            std::cout << characters;
-        }
+    closeStartTag();
+
+    // the characters of CDATA are written as character content, so each <, &, and > is escaped
+    writeEscaped(characters);
 }
 
 void identityParser::handleProcessingInstruction(std::string_view target, std::string_view data) {
 
-    std::cout << "<?" << target << " " << data << "?>";
+    closeStartTag();
+    output.write("<?"sv);
+    output.write(target);
+    output.write(' ');
+    output.write(data);
+    output.write("?>"sv);
 }
 
 void identityParser::handleCharacterEntityReferences(std::string_view characters) {
 
-    if(characters == "<") {
-        std::cout << "&lt;";
-    } else if(characters == "&") {
-        std::cout << "&amp;";
-    } else if(characters == ">") {
-        std::cout << "&gt;";
-    } else {
-        std::cout << characters;
-    }
+    closeStartTag();
+    writeCharacters(characters);
 }
 
 void identityParser::handleCharacterNonEntityReferences(std::string_view characters) {
 
-    if(characters == "<") {
-        std::cout << "&lt;";
-    } else if(characters == "&") {
-        std::cout << "&amp;";
-    } else if(characters == ">") {
-        std::cout << "&gt;";
+    closeStartTag();
+    writeCharacters(characters);
+}
+
+void identityParser::handleEndDocument() {
+
+    closeStartTag();
+    output.flush();
+}
+
+void identityParser::handleRaw(std::string_view raw) {
+
+    output.write(raw);
+}
+
+// write the characters, with a single <, &, or > escaped
+void identityParser::writeCharacters(std::string_view characters) {
+
+    if (characters == "<"sv) {
+        output.write("&lt;"sv);
+    } else if (characters == "&"sv) {
+        output.write("&amp;"sv);
+    } else if (characters == ">"sv) {
+        output.write("&gt;"sv);
     } else {
-        std::cout << characters;
+        output.write(characters);
     }
 }
 
-void identityParser::handleEndDocument() {
+// write the characters, with all <, &, and > escaped
+void identityParser::writeEscaped(std::string_view characters) {
 
-    // std::cout << "\n";
-    // std::cout.close();
-}
\ No newline at end of file
+    std::size_t escapePosition;
+    while ((escapePosition = characters.find_first_of("<&>"sv)) != characters.npos) {
+        output.write(characters.substr(0, escapePosition));
+        writeCharacters(characters.substr(escapePosition, 1));
+        characters.remove_prefix(escapePosition + 1);
+    }
+    output.write(characters);
+}
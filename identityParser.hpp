@@ -5,17 +5,48 @@
     The output XML is the same (as much as possible) as the input XML.
 
     There are no CDATA parts, but escape all >, <, and & in Character and CDATA content.
+
+    In passthrough mode, the parser reports the unchanged markup and characters
+    as raw source spans, which are copied to the output as is. Only CDATA is
+    rewritten, as escaped characters.
 */
 
 #ifndef INCLUDED_IDENTITYPARSER_HPP
 #define INCLUDED_IDENTITYPARSER_HPP
 
 #include "XMLParser.hpp"
+#include "OutputSink.hpp"
 
 class identityParser : public XMLParserHandler {
 
     private:
 
+    OutputSink output;
+
+    // copy raw source spans, and only rewrite CDATA
+    bool passthrough;
+
+    // start tag is open for attributes and namespaces, closed by the next event
+    bool inStartTag = false;
+
+    // close an open start tag
+    void closeStartTag() {
+
+        if (inStartTag) {
+            output.write('>');
+            inStartTag = false;
+        }
+    }
+
+    // write the characters, with a single <, &, or > escaped
+    void writeCharacters(std::string_view characters);
+
+    // write the characters, with all <, &, and > escaped
+    void writeEscaped(std::string_view characters);
+
+    // Events used, with only CDATA and raw spans in passthrough mode
+    unsigned int events() const override;
+
     // Override function for handlers
     void handleStartDocument() override;
 
@@ -23,11 +54,11 @@ class identityParser : public XMLParserHandler {
 
     void handleDOCTYPE() override;
 
-    void handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+    Directive handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) override;
 
-    void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+    void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) override;
 
-    void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) override;
+    void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value, int nameID) override;
 
     void handleNamespace(std::string_view prefix, std::string_view uri) override;
 
@@ -43,9 +74,12 @@ class identityParser : public XMLParserHandler {
 
     void handleEndDocument() override;
 
+    void handleRaw(std::string_view raw) override;
+
     public:
 
-    identityParser();
+    // constructor, with output to the file descriptor
+    explicit identityParser(int fd = 1, bool passthrough = false);
 
 };
 
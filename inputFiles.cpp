@@ -0,0 +1,75 @@
+/*
+    inputFiles.cpp
+
+    Implementation file for the input files of the command line, parsed in parallel
+*/
+
+#include "inputFiles.hpp"
+
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+#if !defined(_MSC_VER)
+#include <glob.h>
+#endif
+
+/*
+    Expand the arguments into the paths of the input files.
+    An argument with a glob pattern, i.e., '*', '?', or '[', that the shell
+    did not expand, e.g., quoted, is expanded to the matching paths in sorted order.
+
+    @param arguments Paths and glob patterns
+    @param[out] paths Paths of the input files
+    @param[out] unmatched First glob pattern without a matching path
+    @return If every glob pattern has a matching path
+*/
+[[nodiscard]] bool expandInputFiles(const std::vector<std::string_view>& arguments, std::vector<std::string>& paths, std::string& unmatched) {
+
+    for (const auto argument : arguments) {
+#if !defined(_MSC_VER)
+        if (argument.find_first_of("*?[") != std::string_view::npos) {
+            glob_t matches;
+            const int status = glob(std::string(argument).c_str(), 0, nullptr, &matches);
+            if (status == 0)
+                paths.insert(paths.end(), matches.gl_pathv, matches.gl_pathv + matches.gl_pathc);
+            globfree(&matches);
+            if (status != 0) {
+                unmatched = argument;
+                return false;
+            }
+            continue;
+        }
+#endif
+        paths.emplace_back(argument);
+    }
+
+    return true;
+}
+
+/*
+    Run the task for each index with a pool of worker threads.
+    Each worker takes the next index when its task is done, so a long task
+    does not hold up the others.
+
+    @param count Number of indices
+    @param jobs Number of worker threads
+    @param task Task for an index
+*/
+void parallelFor(std::size_t count, int jobs, const std::function<void(std::size_t)>& task) {
+
+    std::atomic<std::size_t> next = 0;
+    auto worker = [&]() {
+        for (std::size_t i = next++; i < count; i = next++)
+            task(i);
+    };
+
+    // no more workers than tasks
+    const int workerCount = static_cast<int>(std::min<std::size_t>(jobs, count));
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i)
+        workers.emplace_back(worker);
+    for (auto& thread : workers)
+        thread.join();
+}
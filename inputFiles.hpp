@@ -0,0 +1,38 @@
+/*
+    inputFiles.hpp
+
+    Include file for the input files of the command line, parsed in parallel
+*/
+
+#ifndef INCLUDED_INPUTFILES_HPP
+#define INCLUDED_INPUTFILES_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+
+/*
+    Expand the arguments into the paths of the input files.
+    An argument with a glob pattern, i.e., '*', '?', or '[', that the shell
+    did not expand, e.g., quoted, is expanded to the matching paths in sorted order.
+
+    @param arguments Paths and glob patterns
+    @param[out] paths Paths of the input files
+    @param[out] unmatched First glob pattern without a matching path
+    @return If every glob pattern has a matching path
+*/
+[[nodiscard]] bool expandInputFiles(const std::vector<std::string_view>& arguments, std::vector<std::string>& paths, std::string& unmatched);
+
+/*
+    Run the task for each index with a pool of worker threads.
+    Each worker takes the next index when its task is done, so a long task
+    does not hold up the others.
+
+    @param count Number of indices
+    @param jobs Number of worker threads
+    @param task Task for an index
+*/
+void parallelFor(std::size_t count, int jobs, const std::function<void(std::size_t)>& task);
+
+#endif
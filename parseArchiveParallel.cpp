@@ -0,0 +1,103 @@
+/*
+    parseArchiveParallel.cpp
+
+    Implementation file for parsing the units of a srcML archive in parallel
+*/
+
+#include "parseArchiveParallel.hpp"
+#include "splitArchive.hpp"
+#include "MemoryInputSource.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+    Parse a srcML archive with a pool of worker threads.
+
+    The archive is split at its nested units. Each worker parses units
+    with its own XMLParser and srcFactsParser, and the counts of all
+    workers are merged into the handler. The workers report the units
+    to the unit report of the handler, if any. After a parse error in a
+    unit, the units that follow it are skipped, so the error is the
+    earliest in the document, as for a serial parse.
+
+    @param document Entire srcML document
+    @param[in, out] handler Handler for the merged counts
+    @param[out] error Earliest parse error in the document, if any
+    @param jobs Number of worker threads
+    @param tokenizer Tokenizer of the parsers
+    @return If the document is an archive with nested units
+*/
+[[nodiscard]] bool parseArchiveParallel(std::string_view document, srcFactsParser& handler, XMLParseError& error, int jobs, Tokenizer tokenizer) {
+
+    ArchiveParts parts;
+    if (!splitArchive(document, parts))
+        return false;
+
+    // workers take the next unit until all are parsed
+    std::atomic<std::size_t> nextUnit = 0;
+    std::vector<srcFactsParser> handlers(jobs);
+
+    // units are reported by the workers, as the root has none of its own
+    UnitReport* unitReport = handler.getUnitReport();
+    for (auto& workerHandler : handlers) {
+        workerHandler.setUnitReport(unitReport);
+        workerHandler.setRootLanguage(parts.language);
+    }
+    handler.setUnitReport(nullptr);
+
+    // earliest parse error, with the offset in the document, and the first unit after it
+    std::mutex errorMutex;
+    std::atomic<std::size_t> stopUnit = parts.units.size();
+    auto addError = [&](XMLParseError&& partError, long long partOffset, std::size_t nextPart) {
+        partError.offset += partOffset;
+        const std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error || partError.offset < error.offset)
+            error = std::move(partError);
+        if (nextPart < stopUnit)
+            stopUnit = nextPart;
+    };
+    auto worker = [&](srcFactsParser& workerHandler) {
+        for (std::size_t i = nextUnit++; i < stopUnit; i = nextUnit++) {
+            MemoryInputSource input(parts.units[i]);
+            BasicXMLParser<srcFactsParser> parser(workerHandler, input, tokenizer);
+            for (const auto& [prefix, uri] : parts.namespaces)
+                parser.bindNamespace(prefix, uri);
+            if (auto unitError = parser.parseFragment())
+                addError(std::move(unitError), parts.units[i].data() - document.data(), i + 1);
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(jobs);
+    for (auto& workerHandler : handlers)
+        workers.emplace_back(worker, std::ref(workerHandler));
+
+    // root of the archive is parsed while the workers parse the units
+    MemoryInputSource rootInput(parts.root);
+    BasicXMLParser<srcFactsParser> rootParser(handler, rootInput, tokenizer);
+    if (auto rootError = rootParser.parse()) {
+
+        // an error before the units stops all the units
+        const long long rootOffset = rootError.offset;
+        const long long offset = rootToDocumentOffset(document, parts, rootOffset);
+        const std::size_t stopAt = offset < parts.units.front().data() - document.data() ? 0 : parts.units.size();
+        addError(std::move(rootError), offset - rootOffset, stopAt);
+    }
+    handler.setUnitReport(unitReport);
+
+    for (auto& thread : workers)
+        thread.join();
+
+#ifdef INSTRUMENT
+    // units parsed by the workers, in one report for all the workers
+    Instrumentation::reportFragments(std::clog);
+#endif
+
+    for (const auto& workerHandler : handlers)
+        handler.merge(workerHandler);
+
+    return true;
+}
@@ -0,0 +1,33 @@
+/*
+    parseArchiveParallel.hpp
+
+    Include file for parsing the units of a srcML archive in parallel
+*/
+
+#ifndef INCLUDED_PARSEARCHIVEPARALLEL_HPP
+#define INCLUDED_PARSEARCHIVEPARALLEL_HPP
+
+#include <string_view>
+
+#include "srcFactsParser.hpp"
+
+/*
+    Parse a srcML archive with a pool of worker threads.
+
+    The archive is split at its nested units. Each worker parses units
+    with its own XMLParser and srcFactsParser, and the counts of all
+    workers are merged into the handler. The workers report the units
+    to the unit report of the handler, if any. After a parse error in a
+    unit, the units that follow it are skipped, so the error is the
+    earliest in the document, as for a serial parse.
+
+    @param document Entire srcML document
+    @param[in, out] handler Handler for the merged counts
+    @param[out] error Earliest parse error in the document, if any
+    @param jobs Number of worker threads
+    @param tokenizer Tokenizer of the parsers
+    @return If the document is an archive with nested units
+*/
+[[nodiscard]] bool parseArchiveParallel(std::string_view document, srcFactsParser& handler, XMLParseError& error, int jobs, Tokenizer tokenizer = Tokenizer::SCAN);
+
+#endif
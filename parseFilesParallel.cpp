@@ -0,0 +1,229 @@
+/*
+    parseFilesParallel.cpp
+
+    Implementation file for parsing many srcML files in parallel
+*/
+
+#include "parseFilesParallel.hpp"
+#include "splitArchive.hpp"
+#include "WholeDocument.hpp"
+#include "MemoryInputSource.hpp"
+
+#include <list>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <algorithm>
+
+#if !defined(_MSC_VER)
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+namespace {
+
+    // archive with units shared by the workers
+    struct OpenArchive {
+
+        // index of the file
+        std::size_t file;
+
+        std::unique_ptr<WholeDocument> document;
+        ArchiveParts parts;
+
+        // next unit to parse, and the first unit not parsed after an error
+        std::size_t nextUnit = 0;
+        std::size_t stopUnit = 0;
+
+        // workers with counts of the archive not yet merged into its file
+        int helpers = 1;
+    };
+
+    // entire document of the file, nullptr if the file cannot be opened
+    [[nodiscard]] std::unique_ptr<WholeDocument> loadFile(const std::string& path) {
+
+#if !defined(_MSC_VER)
+        const int fd = open(path.c_str(), O_RDONLY);
+#else
+        const int fd = _open(path.c_str(), _O_RDONLY | _O_BINARY);
+#endif
+        if (fd == -1)
+            return nullptr;
+
+        // mapping remains valid after the file is closed
+        auto document = std::make_unique<WholeDocument>(fd);
+#if !defined(_MSC_VER)
+        close(fd);
+#else
+        _close(fd);
+#endif
+        return document;
+    }
+
+    // error of the file, with the message and no offset
+    [[nodiscard]] XMLParseError fileError(XMLErrorCode code, std::string_view message) {
+
+        XMLParseError error;
+        error.code = code;
+        error.message = message;
+        return error;
+    }
+}
+
+/*
+    Parse srcML files with a pool of worker threads.
+
+    Each worker takes the next file, and when the file is an archive, the
+    units of the archive are shared with the other workers. A worker takes
+    units of the open archives before it takes the next file, so a large
+    archive is parsed by all the workers, not just the one that opened it.
+    A file that is not an archive is parsed by a single worker.
+
+    @param[in, out] files Files to parse, with the counts and error of each
+    @param jobs Number of worker threads
+    @param tokenizer Tokenizer of the parsers
+    @param unitReport Report for the units of all the files, nullptr for none
+*/
+void parseFilesParallel(std::vector<FileFacts>& files, int jobs, Tokenizer tokenizer, UnitReport* unitReport) {
+
+    // open archives, the next file, and the counts and errors of the files
+    std::mutex mutex;
+    std::list<OpenArchive> archives;
+    std::size_t nextFile = 0;
+
+    // error of a part of an archive, with the units after the error not parsed, called with the lock
+    auto addError = [&](OpenArchive& archive, XMLParseError&& error, long long partOffset, std::size_t stopAt) {
+        error.offset += partOffset;
+        XMLParseError& firstError = files[archive.file].error;
+        if (!firstError || error.offset < firstError.offset)
+            firstError = std::move(error);
+        archive.stopUnit = std::min(archive.stopUnit, stopAt);
+    };
+
+    auto worker = [&]() {
+
+        // counts of the current archive, not yet merged into its file
+        srcFactsParser handler;
+        handler.setUnitReport(unitReport);
+        OpenArchive* current = nullptr;
+
+        // merge the counts into the file of the current archive, with the archive closed after
+        // its last unit and last worker, called with the lock
+        auto leave = [&]() {
+            files[current->file].handler.merge(handler);
+            handler.reset();
+            if (--current->helpers == 0 && current->nextUnit >= current->stopUnit)
+                archives.remove_if([current](const OpenArchive& archive) { return &archive == current; });
+            current = nullptr;
+        };
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+
+            // unit of an open archive, preferring the current archive
+            OpenArchive* archive = current && current->nextUnit < current->stopUnit ? current : nullptr;
+            for (auto it = archives.begin(); !archive && it != archives.end(); ++it) {
+                if (it->nextUnit < it->stopUnit)
+                    archive = &*it;
+            }
+            if (archive) {
+                if (archive != current) {
+                    if (current)
+                        leave();
+                    current = archive;
+                    ++current->helpers;
+                    handler.setRootLanguage(current->parts.language);
+                }
+                const std::size_t unit = current->nextUnit++;
+                lock.unlock();
+
+                const std::string_view unitDocument = current->parts.units[unit];
+                MemoryInputSource input(unitDocument);
+                BasicXMLParser<srcFactsParser> parser(handler, input, tokenizer);
+                for (const auto& [prefix, uri] : current->parts.namespaces)
+                    parser.bindNamespace(prefix, uri);
+                XMLParseError error = parser.parseFragment();
+
+                lock.lock();
+                if (error)
+                    addError(*current, std::move(error), unitDocument.data() - current->document->view().data(), unit + 1);
+                continue;
+            }
+
+            // no units left in the open archives, so the next file
+            if (current)
+                leave();
+            if (nextFile == files.size())
+                return;
+            const std::size_t fileIndex = nextFile++;
+            FileFacts& file = files[fileIndex];
+            lock.unlock();
+
+            auto document = loadFile(file.path);
+            if (!document || !document->isLoaded()) {
+                file.error = !document ? fileError(XMLErrorCode::INPUT, "srcfacts error : Unable to open file")
+                                       : fileError(XMLErrorCode::INPUT, document->error());
+                lock.lock();
+                continue;
+            }
+            file.totalBytes = static_cast<long long>(document->view().size());
+
+            // document that is not an archive is parsed serially
+            ArchiveParts parts;
+            if (!splitArchive(document->view(), parts)) {
+                MemoryInputSource input(document->view());
+                file.handler.setUnitReport(unitReport);
+                BasicXMLParser<srcFactsParser> parser(file.handler, input, tokenizer);
+                file.error = parser.parse();
+                file.handler.setUnitReport(nullptr);
+                lock.lock();
+                continue;
+            }
+
+            // units are shared while the root is parsed
+            lock.lock();
+            archives.push_back(OpenArchive{ fileIndex, std::move(document), std::move(parts) });
+            current = &archives.back();
+            current->stopUnit = current->parts.units.size();
+            lock.unlock();
+
+            // units without a language are in the language of the root
+            handler.setRootLanguage(current->parts.language);
+
+            // root is not reported, as it has no units of its own
+            handler.setUnitReport(nullptr);
+            MemoryInputSource rootInput(current->parts.root);
+            BasicXMLParser<srcFactsParser> rootParser(handler, rootInput, tokenizer);
+            XMLParseError rootError = rootParser.parse();
+            handler.setUnitReport(unitReport);
+
+            lock.lock();
+            if (rootError) {
+
+                // an error before the units stops all the units
+                const std::string_view view = current->document->view();
+                const long long rootOffset = rootError.offset;
+                const long long offset = rootToDocumentOffset(view, current->parts, rootOffset);
+                const std::size_t stopAt = offset < current->parts.units.front().data() - view.data() ? 0 : current->parts.units.size();
+                addError(*current, std::move(rootError), offset - rootOffset, stopAt);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(jobs);
+    for (int i = 0; i < jobs; ++i)
+        workers.emplace_back(worker);
+    for (auto& thread : workers)
+        thread.join();
+
+#ifdef INSTRUMENT
+    // units parsed by the workers, in one report for all the workers
+    Instrumentation::reportFragments(std::clog);
+#endif
+}
@@ -0,0 +1,46 @@
+/*
+    parseFilesParallel.hpp
+
+    Include file for parsing many srcML files in parallel
+*/
+
+#ifndef INCLUDED_PARSEFILESPARALLEL_HPP
+#define INCLUDED_PARSEFILESPARALLEL_HPP
+
+#include <string>
+#include <vector>
+
+#include "srcFactsParser.hpp"
+
+// counts of a srcML file
+struct FileFacts {
+
+    std::string path;
+
+    // counts of the file, without the units after an error
+    srcFactsParser handler;
+
+    // size of the document, decompressed
+    long long totalBytes = 0;
+
+    // input or parse error of the file, if any
+    XMLParseError error;
+};
+
+/*
+    Parse srcML files with a pool of worker threads.
+
+    Each worker takes the next file, and when the file is an archive, the
+    units of the archive are shared with the other workers. A worker takes
+    units of the open archives before it takes the next file, so a large
+    archive is parsed by all the workers, not just the one that opened it.
+    A file that is not an archive is parsed by a single worker.
+
+    @param[in, out] files Files to parse, with the counts and error of each
+    @param jobs Number of worker threads
+    @param tokenizer Tokenizer of the parsers
+    @param unitReport Report for the units of all the files, nullptr for none
+*/
+void parseFilesParallel(std::vector<FileFacts>& files, int jobs, Tokenizer tokenizer = Tokenizer::SCAN, UnitReport* unitReport = nullptr);
+
+#endif
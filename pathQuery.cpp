@@ -0,0 +1,93 @@
+/*
+    pathQuery.cpp
+
+    Count, or extract the text of, the elements of srcML that match path queries,
+    e.g., function/name, class//decl_stmt, or /unit/unit[@language='C++'].
+    All the queries are evaluated in one pass over the document.
+
+    Markdown report with the count of each query, or with --extract, the text of
+    each match on its own line, in the order the matches end. With more than one
+    query, each line starts with the query and a tab.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <locale>
+
+#include "InputSource.hpp"
+#include "XMLParser.hpp"
+#include "pathQueryParser.hpp"
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+int main(int argc, char* argv[]) {
+
+    bool extract = false;
+    std::vector<std::string_view> paths;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (arg == "--extract"sv || arg == "-x"sv) {
+            extract = true;
+        } else if (!arg.empty() && arg[0] != '-') {
+            paths.push_back(arg);
+        } else {
+            paths.clear();
+            break;
+        }
+    }
+    if (paths.empty()) {
+        std::cerr << "usage: pathquery [--extract] path ... < file.xml\n";
+        return 1;
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    pathQueryParser handler(extract ? 1 : -1);
+    for (const auto path : paths) {
+        std::string error;
+        if (!handler.addQuery(path, error)) {
+            std::cerr << error << '\n';
+            return 1;
+        }
+    }
+
+    auto input = makeInputSource();
+    BasicXMLParser<pathQueryParser> parser(handler, *input);
+    if (const auto error = parser.parse()) {
+        std::cerr << error.message << '\n';
+        return 1;
+    }
+
+    const auto finishTime = std::chrono::steady_clock::now();
+    const auto elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count();
+
+    // output the count of each query
+    if (!extract) {
+        std::size_t pathWidth = "Query"sv.size();
+        for (int query = 0; query < handler.getQueryCount(); ++query)
+            pathWidth = std::max(pathWidth, handler.getPath(query).size());
+        std::cout.imbue(std::locale{""});
+        std::cout << "# pathquery:\n";
+        std::cout << "| " << std::setw(static_cast<int>(pathWidth)) << std::left << "Query" << std::right << " | " << std::setw(12) << "Count" << " |\n";
+        std::cout << "|:" << std::string(pathWidth, '-') << "-|-" << std::string(12, '-') << ":|\n";
+        for (int query = 0; query < handler.getQueryCount(); ++query) {
+            std::cout << "| " << std::setw(static_cast<int>(pathWidth)) << std::left << handler.getPath(query) << std::right
+                      << " | " << std::setw(12) << handler.getCount(query) << " |\n";
+        }
+    }
+    std::clog.imbue(std::locale{""});
+    std::clog.precision(3);
+    std::clog << '\n';
+    std::clog << parser.getTotalBytes() << " bytes\n";
+    std::clog << elapsedSeconds << " sec\n";
+    std::clog << static_cast<long long>(parser.getTotalBytes() / elapsedSeconds) << " bytes/sec\n";
+    std::clog << handler.getStateCount() << " states\n";
+
+    return 0;
+}
@@ -0,0 +1,395 @@
+/*
+    pathQueryParser.cpp
+
+    Implementation file for counting and extracting the elements of srcML that match
+    path queries.
+*/
+
+#include "pathQueryParser.hpp"
+#include "XMLParserImpl.hpp"
+
+#include <algorithm>
+
+// XML parser with direct calls to the pathQueryParser
+template class BasicXMLParser<pathQueryParser>;
+
+namespace {
+
+    // characters that end a name in a query
+    constexpr std::string_view NAME_END = "/[]@=\"' \t\n\r"sv;
+
+    // split the qualified name into the prefix and the local name
+    std::pair<std::string_view, std::string_view> splitName(std::string_view qName) {
+
+        const std::size_t colonPosition = qName.find(':');
+        if (colonPosition == qName.npos)
+            return { ""sv, qName };
+        return { qName.substr(0, colonPosition), qName.substr(colonPosition + 1) };
+    }
+}
+
+// constructor, with the text of each match written as a line to the file descriptor, -1 to only count
+pathQueryParser::pathQueryParser(int extractFD) {
+
+    if (extractFD != -1)
+        output = std::make_unique<OutputSink>(extractFD);
+}
+
+/*
+    Compile the query and add it to the automaton, before the parse
+
+    @param path Path of the query, e.g., function/name
+    @param[out] error Message of a syntax error in the query
+    @return If the query is valid
+*/
+[[nodiscard]] bool pathQueryParser::addQuery(std::string_view path, std::string& error) {
+
+    Query query;
+    query.path = path;
+
+    // a path not from the root element starts with any element of the document
+    std::string_view rest = path;
+    bool descendant = true;
+    if (rest.compare(0, "//"sv.size(), "//"sv) == 0) {
+        rest.remove_prefix("//"sv.size());
+    } else if (rest.compare(0, "/"sv.size(), "/"sv) == 0) {
+        rest.remove_prefix("/"sv.size());
+        descendant = false;
+    }
+    while (true) {
+
+        // name of the step, or * for any element
+        Step step;
+        step.descendant = descendant;
+        const std::size_t nameEnd = std::min(rest.find_first_of(NAME_END), rest.size());
+        const std::string_view qName = rest.substr(0, nameEnd);
+        if (qName.empty() || qName.front() == ':' || qName.back() == ':') {
+            error = "pathquery error : Missing element name in query '" + query.path + "'";
+            return false;
+        }
+        if (qName == "*"sv) {
+            step.nameID = ANY_NAME;
+        } else {
+            const auto [prefix, localName] = splitName(qName);
+            step.nameID = names.intern(prefix, localName);
+        }
+        rest.remove_prefix(nameEnd);
+
+        // attribute predicates, i.e., [@name] or [@name='value']
+        while (!rest.empty() && rest[0] == '[') {
+            if (rest.size() < "[@"sv.size() || rest[1] != '@') {
+                error = "pathquery error : Predicate is not on an attribute in query '" + query.path + "'";
+                return false;
+            }
+            rest.remove_prefix("[@"sv.size());
+            const std::size_t attributeEnd = std::min(rest.find_first_of(NAME_END), rest.size());
+            const std::string_view attributeName = rest.substr(0, attributeEnd);
+            if (attributeName.empty()) {
+                error = "pathquery error : Missing attribute name in query '" + query.path + "'";
+                return false;
+            }
+            const auto [prefix, localName] = splitName(attributeName);
+            Predicate predicate{ names.intern(prefix, localName), std::nullopt };
+            rest.remove_prefix(attributeEnd);
+            if (!rest.empty() && rest[0] == '=') {
+                const std::size_t valueEnd = rest.size() > 1 && (rest[1] == '"' || rest[1] == '\'') ? rest.find(rest[1], 2) : rest.npos;
+                if (valueEnd == rest.npos) {
+                    error = "pathquery error : Attribute value is not quoted in query '" + query.path + "'";
+                    return false;
+                }
+                predicate.value = std::string(rest.substr(2, valueEnd - 2));
+                rest.remove_prefix(valueEnd + 1);
+            }
+            if (rest.empty() || rest[0] != ']') {
+                error = "pathquery error : Unterminated predicate in query '" + query.path + "'";
+                return false;
+            }
+            rest.remove_prefix("]"sv.size());
+            if (static_cast<std::size_t>(predicate.nameID) >= predicateNames.size())
+                predicateNames.resize(predicate.nameID + 1, false);
+            predicateNames[predicate.nameID] = true;
+            step.predicates.push_back(std::move(predicate));
+        }
+        query.steps.push_back(std::move(step));
+
+        // axis of the next step
+        if (rest.empty())
+            break;
+        if (rest.compare(0, "//"sv.size(), "//"sv) == 0) {
+            rest.remove_prefix("//"sv.size());
+            descendant = true;
+        } else if (rest[0] == '/') {
+            rest.remove_prefix("/"sv.size());
+            descendant = false;
+        } else {
+            error = "pathquery error : Invalid character '" + std::string(1, rest[0]) + "' in query '" + query.path + "'";
+            return false;
+        }
+    }
+
+    // a step state for each step, and the final state
+    query.firstStep = static_cast<int>(stepStates.size());
+    const int queryID = static_cast<int>(queries.size());
+    for (int step = 0; step <= static_cast<int>(query.steps.size()); ++step)
+        stepStates.push_back({ queryID, step });
+    queries.push_back(std::move(query));
+
+    return true;
+}
+
+// query name ID of a parser name ID
+int pathQueryParser::queryName(std::string_view prefix, std::string_view localName, int nameID) {
+
+    // srcML names have the same ID in all name tables
+    if (nameID < NameTable::SRCML_NAME_COUNT)
+        return nameID;
+
+    const std::size_t index = static_cast<std::size_t>(nameID - NameTable::SRCML_NAME_COUNT);
+    if (index >= parserNames.size())
+        parserNames.resize(index + 1, UNKNOWN_STATE);
+    if (parserNames[index] == UNKNOWN_STATE)
+        parserNames[index] = names.intern(prefix, localName);
+    return parserNames[index];
+}
+
+// state of the set of step states, created the first time
+int pathQueryParser::stateOf(std::vector<int> steps) {
+
+    std::sort(steps.begin(), steps.end());
+    steps.erase(std::unique(steps.begin(), steps.end()), steps.end());
+    const auto found = stateIDs.find(steps);
+    if (found != stateIDs.end())
+        return found->second;
+
+    State state;
+    for (const int stepState : steps) {
+        const StepState& step = stepStates[stepState];
+        if (step.step == static_cast<int>(queries[step.query].steps.size()))
+            state.matches.push_back(step.query);
+        else
+            state.skippable = false;
+    }
+    state.steps = steps;
+    const int stateID = static_cast<int>(states.size());
+    states.push_back(std::move(state));
+    stateIDs.emplace(std::move(steps), stateID);
+
+    return stateID;
+}
+
+// transition from the state on the query name ID, created the first time
+pathQueryParser::Transition pathQueryParser::transition(int state, int nameID) {
+
+    if (static_cast<std::size_t>(nameID) < states[state].transitions.size()) {
+        const Transition& cached = states[state].transitions[nameID];
+        if (cached.state != UNKNOWN_STATE || cached.conditional != -1)
+            return cached;
+    }
+
+    // a descendant step stays for the elements below, and a matching step moves to the next step
+    std::vector<int> next;
+    std::vector<int> candidates;
+    for (const int stepState : states[state].steps) {
+        const StepState& step = stepStates[stepState];
+        const std::vector<Step>& steps = queries[step.query].steps;
+        if (step.step == static_cast<int>(steps.size()))
+            continue;
+        const Step& current = steps[step.step];
+        if (current.descendant)
+            next.push_back(stepState);
+        if (current.nameID == ANY_NAME || current.nameID == nameID) {
+            if (current.predicates.empty())
+                next.push_back(stepState + 1);
+            else
+                candidates.push_back(stepState);
+        }
+    }
+    Transition created;
+    if (candidates.empty()) {
+        created.state = stateOf(std::move(next));
+    } else {
+        created.conditional = static_cast<int>(conditionals.size());
+        conditionals.push_back({ std::move(next), std::move(candidates) });
+    }
+
+    // states may have moved with a new state
+    std::vector<Transition>& transitions = states[state].transitions;
+    if (static_cast<std::size_t>(nameID) >= transitions.size())
+        transitions.resize(std::max(static_cast<std::size_t>(nameID) + 1, static_cast<std::size_t>(names.size())));
+    transitions[nameID] = created;
+
+    return created;
+}
+
+// if the attributes of the current start tag satisfy the predicates of the step state
+bool pathQueryParser::satisfies(int stepState) const {
+
+    const StepState& step = stepStates[stepState];
+    for (const Predicate& predicate : queries[step.query].steps[step.step].predicates) {
+        const auto attribute = std::find_if(attributes.cbegin(), attributes.cend(),
+            [&predicate](const std::pair<int, std::string>& attribute) { return attribute.first == predicate.nameID; });
+        if (attribute == attributes.cend() || (predicate.value && attribute->second != *predicate.value))
+            return false;
+    }
+
+    return true;
+}
+
+// enter the element with the state, counting its matches
+void pathQueryParser::enter(int state) {
+
+    stack.push_back(state);
+    for (const int query : states[state].matches) {
+        ++queries[query].count;
+        if (output)
+            openMatches.push_back({ query, stack.size(), std::string() });
+    }
+}
+
+// enter the current start tag once its attributes are known
+void pathQueryParser::resolvePending() {
+
+    if (pendingConditional == -1)
+        return;
+
+    const ConditionalTransition& conditional = conditionals[pendingConditional];
+    std::vector<int> next = conditional.steps;
+    for (const int stepState : conditional.candidates) {
+        if (satisfies(stepState))
+            next.push_back(stepState + 1);
+    }
+    pendingConditional = -1;
+    enter(stateOf(std::move(next)));
+}
+
+// write the text of a match as a line, with the query for more than one query
+void pathQueryParser::writeMatch(const OpenMatch& match) {
+
+    if (queries.size() > 1) {
+        output->write(queries[match.query].path);
+        output->write('\t');
+    }
+
+    // newlines and tabs are escaped, so each match is one line
+    for (const char c : match.text) {
+        if (c == '\n') {
+            output->write("\\n"sv);
+        } else if (c == '\t') {
+            output->write("\\t"sv);
+        } else if (c == '\\') {
+            output->write("\\\\"sv);
+        } else {
+            output->write(c);
+        }
+    }
+    output->write('\n');
+}
+
+// Events used, with attributes only for predicates, and characters only for extraction
+unsigned int pathQueryParser::events() const {
+
+    return START_DOCUMENT | START_TAG | END_TAG | END_DOCUMENT
+         | (!predicateNames.empty() ? ATTRIBUTE : 0U)
+         | (output ? CDATA | CHARACTER_ENTITY_REFERENCES | CHARACTER_NON_ENTITY_REFERENCES : 0U);
+}
+
+void pathQueryParser::handleStartDocument() {
+
+    // the document waits for the first step of each query
+    std::vector<int> firstSteps;
+    for (const Query& query : queries)
+        firstSteps.push_back(query.firstStep);
+    stack.clear();
+    stack.push_back(stateOf(std::move(firstSteps)));
+    pendingConditional = -1;
+    openMatches.clear();
+}
+
+XMLParserHandler::Directive pathQueryParser::handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) {
+
+    resolvePending();
+    const Transition next = transition(stack.back(), queryName(prefix, localName, nameID));
+    if (next.conditional != -1) {
+        pendingConditional = next.conditional;
+        attributes.clear();
+        return CONTINUE;
+    }
+    enter(next.state);
+
+    // no query can match below the element, so unless a match needs its text, it is skipped
+    return states[next.state].skippable && openMatches.empty() ? SKIP : CONTINUE;
+}
+
+void pathQueryParser::handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) {
+
+    resolvePending();
+    while (!openMatches.empty() && openMatches.back().depth == stack.size()) {
+        writeMatch(openMatches.back());
+        openMatches.pop_back();
+    }
+    stack.pop_back();
+}
+
+void pathQueryParser::handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value, int nameID) {
+
+    if (pendingConditional == -1)
+        return;
+
+    const int queryNameID = queryName(prefix, localName, nameID);
+    if (static_cast<std::size_t>(queryNameID) < predicateNames.size() && predicateNames[queryNameID])
+        attributes.emplace_back(queryNameID, value);
+}
+
+void pathQueryParser::handleCDATA(std::string_view characters) {
+
+    resolvePending();
+    for (OpenMatch& match : openMatches)
+        match.text += characters;
+}
+
+void pathQueryParser::handleCharacterEntityReferences(std::string_view characters) {
+
+    resolvePending();
+    for (OpenMatch& match : openMatches)
+        match.text += characters;
+}
+
+void pathQueryParser::handleCharacterNonEntityReferences(std::string_view characters) {
+
+    resolvePending();
+    for (OpenMatch& match : openMatches)
+        match.text += characters;
+}
+
+void pathQueryParser::handleEndDocument() {
+
+    // matches of elements that are not closed
+    while (!openMatches.empty()) {
+        writeMatch(openMatches.back());
+        openMatches.pop_back();
+    }
+}
+
+// Get method for the number of queries
+int pathQueryParser::getQueryCount() {
+
+    return static_cast<int>(queries.size());
+}
+
+// Get method for the path of a query
+std::string_view pathQueryParser::getPath(int query) {
+
+    return queries[query].path;
+}
+
+// Get method for the number of matches of a query
+long long pathQueryParser::getCount(int query) {
+
+    return queries[query].count;
+}
+
+// Get method for the number of states of the automaton created by the parse
+int pathQueryParser::getStateCount() {
+
+    return static_cast<int>(states.size());
+}
@@ -0,0 +1,216 @@
+/*
+    pathQueryParser.hpp
+
+    Include file for counting and extracting the elements of srcML that match
+    path queries, e.g., function/name, class//decl_stmt, or /unit/unit[@language='C++'].
+
+    A query is a path of steps, each an element name, a prefixed name, e.g.,
+    cpp:define, or * for any element, with predicates on the attributes of the
+    element, [@name] for an attribute that exists, and [@name='value'] for an
+    attribute with the value. Steps are separated by / for a child, and // for
+    a descendant. A query that starts with / starts at the root element, otherwise
+    the first step is any element of the document.
+
+    All the queries are compiled into one pushdown automaton over the interned
+    name IDs. Each state of the automaton is the set of steps the open element
+    waits for in each query, and is created, along with its transitions, the first
+    time it is reached. The parse keeps a stack of the states of the open elements,
+    so all the queries are evaluated in one streaming pass. An element where no
+    query can match is skipped to its end tag without events.
+*/
+
+#ifndef INCLUDED_PATHQUERYPARSER_HPP
+#define INCLUDED_PATHQUERYPARSER_HPP
+
+#include "XMLParserHandler.hpp"
+#include "XMLParser.hpp"
+#include "NameTable.hpp"
+#include "OutputSink.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+
+class pathQueryParser final : public XMLParserHandler {
+
+    private:
+
+    // parser calls the handler methods directly
+    template <typename Handler>
+    friend class BasicXMLParser;
+
+    // name ID of the step for any element, i.e., *
+    static constexpr int ANY_NAME = -1;
+
+    // automaton state that is not created yet
+    static constexpr int UNKNOWN_STATE = -1;
+
+    // predicate on an attribute of the element, with no value for an attribute that exists
+    struct Predicate {
+        int nameID;
+        std::optional<std::string> value;
+    };
+
+    // step of a query, matching a child, or any descendant, of the element of the previous step
+    struct Step {
+        bool descendant;
+        int nameID;
+        std::vector<Predicate> predicates;
+    };
+
+    struct Query {
+        std::string path;
+        std::vector<Step> steps;
+
+        // step state of the first step, followed by the step states of the other steps, and the final state
+        int firstStep;
+
+        long long count = 0;
+    };
+
+    // query and step of a step state, with the number of steps of the query for its final state
+    struct StepState {
+        int query;
+        int step;
+    };
+
+    // transition of a state on a name, either to a state, or to a state that depends on the attributes
+    struct Transition {
+        int state = UNKNOWN_STATE;
+        int conditional = -1;
+    };
+
+    // state of the automaton, the set of step states of an element
+    struct State {
+        std::vector<int> steps;
+
+        // queries with their final state in the set, i.e., that match the element
+        std::vector<int> matches;
+
+        // no step state waits for a step, so no query can match below the element
+        bool skippable = true;
+
+        // transitions on the query name IDs
+        std::vector<Transition> transitions;
+    };
+
+    // transition with the step states that do not depend on the attributes, and the step states
+    // whose step matches the name, but with predicates on the attributes
+    struct ConditionalTransition {
+        std::vector<int> steps;
+        std::vector<int> candidates;
+    };
+
+    // match that extracts the characters of its element
+    struct OpenMatch {
+        int query;
+        std::size_t depth;
+        std::string text;
+    };
+
+    std::vector<Query> queries;
+    std::vector<StepState> stepStates;
+
+    // states of the automaton, and the state of each set of step states
+    std::vector<State> states;
+    std::map<std::vector<int>, int> stateIDs;
+    std::vector<ConditionalTransition> conditionals;
+
+    // names of the queries, with the same IDs as the parser for srcML names
+    NameTable names;
+
+    // query name IDs of the parser name IDs after the srcML names, UNKNOWN_STATE if not mapped yet
+    std::vector<int> parserNames;
+
+    // names of attributes in predicates, by query name ID
+    std::vector<bool> predicateNames;
+
+    // state of the document, then of each open element
+    std::vector<int> stack;
+
+    // conditional transition of the current start tag, waiting for its attributes, -1 if none
+    int pendingConditional = -1;
+
+    // attributes of the current start tag that are in predicates
+    std::vector<std::pair<int, std::string>> attributes;
+
+    // output of the extracted matches, nullptr when only counting
+    std::unique_ptr<OutputSink> output;
+    std::vector<OpenMatch> openMatches;
+
+    // query name ID of a parser name ID
+    int queryName(std::string_view prefix, std::string_view localName, int nameID);
+
+    // state of the set of step states, created the first time
+    int stateOf(std::vector<int> steps);
+
+    // transition from the state on the query name ID, created the first time
+    Transition transition(int state, int nameID);
+
+    // if the attributes of the current start tag satisfy the predicates of the step state
+    bool satisfies(int stepState) const;
+
+    // enter the element with the state, counting its matches
+    void enter(int state);
+
+    // enter the current start tag once its attributes are known
+    void resolvePending();
+
+    // write the text of a match as a line, with the query for more than one query
+    void writeMatch(const OpenMatch& match);
+
+    // Events used, with attributes only for predicates, and characters and CDATA only for extraction
+    unsigned int events() const override;
+
+    // Override function for handlers
+    void handleStartDocument() override;
+
+    Directive handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) override;
+
+    void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) override;
+
+    void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value, int nameID) override;
+
+    void handleCDATA(std::string_view characters) override;
+
+    void handleCharacterEntityReferences(std::string_view characters) override;
+
+    void handleCharacterNonEntityReferences(std::string_view characters) override;
+
+    void handleEndDocument() override;
+
+    public:
+
+    // constructor, with the text of each match written as a line to the file descriptor, -1 to only count
+    explicit pathQueryParser(int extractFD = -1);
+
+    /*
+        Compile the query and add it to the automaton, before the parse
+
+        @param path Path of the query, e.g., function/name
+        @param[out] error Message of a syntax error in the query
+        @return If the query is valid
+    */
+    [[nodiscard]] bool addQuery(std::string_view path, std::string& error);
+
+    // Get method for the number of queries
+    int getQueryCount();
+
+    // Get method for the path of a query
+    std::string_view getPath(int query);
+
+    // Get method for the number of matches of a query
+    long long getCount(int query);
+
+    // Get method for the number of states of the automaton created by the parse
+    int getStateCount();
+};
+
+// XML parser with direct calls to the pathQueryParser, instantiated in pathQueryParser.cpp
+extern template class BasicXMLParser<pathQueryParser>;
+
+#endif
@@ -19,29 +19,37 @@ typedef SSIZE_T ssize_t;
 #define READ _read
 #endif
 
-const int BLOCK_SIZE = 4096;
-const int BUFFER_SIZE = 16 * 16 * BLOCK_SIZE;
+const std::size_t BLOCK_SIZE = 4096;
 
 /*
     Refill the content preserving the existing data.
 
+    The unprocessed content is moved to the start of the buffer,
+    and the rest of the buffer, except for a final block, is filled from the file.
+
+    @param fd File descriptor to read from
+    @param buffer Buffer that holds the content
+    @param bufferSize Size of the buffer
     @param[in, out] content View of the content
     @return Number of bytes read
     @retval 0 EOF
-    @retval -1 Read error
+    @retval -1 Read error, or the unprocessed content does not leave room to read
 */
-[[nodiscard]] int refillContent(std::string_view& data) {
-
-    // initialize the internal buffer at first use
-    static char buffer[BUFFER_SIZE];
+[[nodiscard]] long refillContent(int fd, char* buffer, std::size_t bufferSize, std::string_view& data) {
 
     // preserve prefix of unprocessed characters to start of the buffer
     std::copy(data.cbegin(), data.cend(), buffer);
 
+    // keep a block at the end of the buffer for lookahead past the content
+    if (data.size() + 2 * BLOCK_SIZE > bufferSize)
+        return -1;
+
     // read in multiple of whole blocks
+    std::size_t readSize = bufferSize - BLOCK_SIZE - data.size();
+    readSize -= readSize % BLOCK_SIZE;
     ssize_t bytesRead = 0;
-    while (((bytesRead = READ(0, (buffer + data.size()),
-        BUFFER_SIZE - BLOCK_SIZE)) == -1) && (errno == EINTR)) {
+    while (((bytesRead = READ(fd, (buffer + data.size()),
+        readSize)) == -1) && (errno == EINTR)) {
     }
     if (bytesRead == -1) {
         // error in read
@@ -8,15 +8,22 @@
 #define INCLUDED_REFILLCONTENT_HPP
 
 #include <string_view>
+#include <cstddef>
 
 /*
     Refill the content preserving the existing data.
 
+    The unprocessed content is moved to the start of the buffer,
+    and the rest of the buffer, except for a final block, is filled from the file.
+
+    @param fd File descriptor to read from
+    @param buffer Buffer that holds the content
+    @param bufferSize Size of the buffer
     @param[in, out] content View of the content
     @return Number of bytes read
     @retval 0 EOF
-    @retval -1 Read error
+    @retval -1 Read error, or the unprocessed content does not leave room to read
 */
-[[nodiscard]] int refillContent(std::string_view& content);
+[[nodiscard]] long refillContent(int fd, char* buffer, std::size_t bufferSize, std::string_view& content);
 
 #endif
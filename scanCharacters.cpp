@@ -0,0 +1,325 @@
+/*
+    scanCharacters.cpp
+
+    Implementation file for scanning the content for structural characters.
+    Uses AVX2 or SSE2 when available, selected at runtime.
+*/
+
+#include "scanCharacters.hpp"
+#include <array>
+#include <cstdint>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SCAN_X86
+#include <immintrin.h>
+#endif
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // lookup table for the characters in a set
+    struct CharacterSet {
+        std::array<bool, 256> contains{};
+
+        constexpr CharacterSet(std::string_view characters) {
+            for (const char c : characters)
+                contains[static_cast<unsigned char>(c)] = true;
+        }
+    };
+
+    constexpr CharacterSet CHARACTEREND("<&"sv);
+    constexpr CharacterSet NAMEEND("> /\":=\n\t\r"sv);
+
+    // scalar scan for any character in the set
+    std::size_t findScalar(const char* data, std::size_t size, std::size_t pos, const CharacterSet& set) {
+
+        for (; pos < size; ++pos) {
+            if (set.contains[static_cast<unsigned char>(data[pos])])
+                return pos;
+        }
+        return std::string_view::npos;
+    }
+
+    // scalar scan for a '<', with the newlines before it
+    std::size_t findTagStartScalar(const char* data, std::size_t size, std::size_t pos, std::size_t& newlines) {
+
+        for (; pos < size; ++pos) {
+            if (data[pos] == '<')
+                return pos;
+            newlines += data[pos] == '\n';
+        }
+        return std::string_view::npos;
+    }
+
+    // scalar count of the newlines
+    std::size_t countNewlinesScalar(const char* data, std::size_t size) {
+
+        std::size_t count = 0;
+        for (std::size_t pos = 0; pos < size; ++pos)
+            count += data[pos] == '\n';
+        return count;
+    }
+
+#ifdef SCAN_X86
+
+    // mask of the bytes of the block in "<&"
+    inline unsigned characterEndMaskSSE2(__m128i block) {
+
+        const __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('<')),
+                                             _mm_cmpeq_epi8(block, _mm_set1_epi8('&')));
+        return static_cast<unsigned>(_mm_movemask_epi8(matches));
+    }
+
+    // mask of the bytes of the block in "> /\":=\n\t\r"
+    inline unsigned nameEndMaskSSE2(__m128i block) {
+
+        __m128i matches = _mm_cmpeq_epi8(block, _mm_set1_epi8('>'));
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, _mm_set1_epi8(' ')));
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, _mm_set1_epi8('/')));
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, _mm_set1_epi8('"')));
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, _mm_set1_epi8(':')));
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, _mm_set1_epi8('=')));
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, _mm_set1_epi8('\n')));
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, _mm_set1_epi8('\t')));
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, _mm_set1_epi8('\r')));
+        return static_cast<unsigned>(_mm_movemask_epi8(matches));
+    }
+
+    std::size_t findCharacterEndSSE2(const char* data, std::size_t size, std::size_t pos) {
+
+        for (; pos + 16 <= size; pos += 16) {
+            const unsigned mask = characterEndMaskSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos)));
+            if (mask)
+                return pos + __builtin_ctz(mask);
+        }
+        return findScalar(data, size, pos, CHARACTEREND);
+    }
+
+    std::size_t findNameEndSSE2(const char* data, std::size_t size, std::size_t pos) {
+
+        for (; pos + 16 <= size; pos += 16) {
+            const unsigned mask = nameEndMaskSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos)));
+            if (mask)
+                return pos + __builtin_ctz(mask);
+        }
+        return findScalar(data, size, pos, NAMEEND);
+    }
+
+    __attribute__((target("avx2")))
+    std::size_t findCharacterEndAVX2(const char* data, std::size_t size, std::size_t pos) {
+
+        const __m256i lt = _mm256_set1_epi8('<');
+        const __m256i amp = _mm256_set1_epi8('&');
+        for (; pos + 32 <= size; pos += 32) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            const __m256i matches = _mm256_or_si256(_mm256_cmpeq_epi8(block, lt), _mm256_cmpeq_epi8(block, amp));
+            const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(matches));
+            if (mask)
+                return pos + __builtin_ctz(mask);
+        }
+        return findCharacterEndSSE2(data, size, pos);
+    }
+
+    __attribute__((target("avx2")))
+    std::size_t findNameEndAVX2(const char* data, std::size_t size, std::size_t pos) {
+
+        // names are short, so check the first 16 bytes before full blocks
+        if (pos + 16 <= size) {
+            const unsigned mask = nameEndMaskSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos)));
+            if (mask)
+                return pos + __builtin_ctz(mask);
+            pos += 16;
+        }
+        for (; pos + 32 <= size; pos += 32) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            __m256i matches = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('>'));
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')));
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, _mm256_set1_epi8('/')));
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, _mm256_set1_epi8('"')));
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(':')));
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, _mm256_set1_epi8('=')));
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n')));
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t')));
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r')));
+            const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(matches));
+            if (mask)
+                return pos + __builtin_ctz(mask);
+        }
+        return findNameEndSSE2(data, size, pos);
+    }
+
+    std::size_t findTagStartSSE2(const char* data, std::size_t size, std::size_t pos, std::size_t& newlines) {
+
+        const __m128i lt = _mm_set1_epi8('<');
+        const __m128i newline = _mm_set1_epi8('\n');
+        for (; pos + 16 <= size; pos += 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            const unsigned ltMask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, lt)));
+            const unsigned newlineMask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+            if (ltMask) {
+
+                // only the newlines before the '<'
+                newlines += __builtin_popcount(newlineMask & ((ltMask & -ltMask) - 1));
+                return pos + __builtin_ctz(ltMask);
+            }
+            newlines += __builtin_popcount(newlineMask);
+        }
+        return findTagStartScalar(data, size, pos, newlines);
+    }
+
+    __attribute__((target("avx2,popcnt")))
+    std::size_t findTagStartAVX2(const char* data, std::size_t size, std::size_t pos, std::size_t& newlines) {
+
+        const __m256i lt = _mm256_set1_epi8('<');
+        const __m256i newline = _mm256_set1_epi8('\n');
+        for (; pos + 32 <= size; pos += 32) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            const unsigned ltMask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, lt)));
+            const unsigned newlineMask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline)));
+            if (ltMask) {
+
+                // only the newlines before the '<'
+                newlines += _mm_popcnt_u32(newlineMask & ((ltMask & -ltMask) - 1));
+                return pos + __builtin_ctz(ltMask);
+            }
+            newlines += _mm_popcnt_u32(newlineMask);
+        }
+        return findTagStartSSE2(data, size, pos, newlines);
+    }
+
+    std::size_t countNewlinesSSE2(const char* data, std::size_t size) {
+
+        const __m128i newline = _mm_set1_epi8('\n');
+        std::size_t count = 0;
+        std::size_t pos = 0;
+        for (; pos + 16 <= size; pos += 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            count += __builtin_popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline))));
+        }
+        return count + countNewlinesScalar(data + pos, size - pos);
+    }
+
+    __attribute__((target("avx2,popcnt")))
+    std::size_t countNewlinesAVX2(const char* data, std::size_t size) {
+
+        const __m256i newline = _mm256_set1_epi8('\n');
+        std::size_t count = 0;
+        std::size_t pos = 0;
+
+        // two blocks per iteration as one 64-bit mask
+        for (; pos + 64 <= size; pos += 64) {
+            const __m256i block1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            const __m256i block2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + 32));
+            const std::uint64_t mask1 = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block1, newline)));
+            const std::uint64_t mask2 = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block2, newline)));
+            count += _mm_popcnt_u64(mask1 | (mask2 << 32));
+        }
+        for (; pos + 32 <= size; pos += 32) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            count += _mm_popcnt_u32(static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline))));
+        }
+        return count + countNewlinesSSE2(data + pos, size - pos);
+    }
+#else
+
+    std::size_t findCharacterEndScalar(const char* data, std::size_t size, std::size_t pos) {
+
+        return findScalar(data, size, pos, CHARACTEREND);
+    }
+
+    std::size_t findNameEndScalar(const char* data, std::size_t size, std::size_t pos) {
+
+        return findScalar(data, size, pos, NAMEEND);
+    }
+#endif
+
+    // scan functions for an instruction set
+    struct Scanner {
+        std::size_t (*findCharacterEnd)(const char*, std::size_t, std::size_t);
+        std::size_t (*findNameEnd)(const char*, std::size_t, std::size_t);
+        std::size_t (*findTagStart)(const char*, std::size_t, std::size_t, std::size_t&);
+        std::size_t (*countNewlines)(const char*, std::size_t);
+        std::string_view instructionSet;
+    };
+
+    // select the scan functions for this processor
+    Scanner selectScanner() {
+
+#ifdef SCAN_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return { findCharacterEndAVX2, findNameEndAVX2, findTagStartAVX2, countNewlinesAVX2, "avx2"sv };
+
+        // SSE2 is part of x86-64
+        return { findCharacterEndSSE2, findNameEndSSE2, findTagStartSSE2, countNewlinesSSE2, "sse2"sv };
+#else
+        return { findCharacterEndScalar, findNameEndScalar, findTagStartScalar, countNewlinesScalar, "scalar"sv };
+#endif
+    }
+
+    const Scanner scanner = selectScanner();
+}
+
+/*
+    Find the end of character content, i.e., the first '<' or '&'.
+
+    @param content View of the content
+    @param pos Position to start the search at
+    @return Position of the first '<' or '&'
+    @retval std::string_view::npos Not found
+*/
+[[nodiscard]] std::size_t findCharacterEnd(std::string_view content, std::size_t pos) {
+
+    return scanner.findCharacterEnd(content.data(), content.size(), pos);
+}
+
+/*
+    Find the end of a name, i.e., the first of "> /\":=" or whitespace.
+
+    @param content View of the content
+    @param pos Position to start the search at
+    @return Position of the first name end character
+    @retval std::string_view::npos Not found
+*/
+[[nodiscard]] std::size_t findNameEnd(std::string_view content, std::size_t pos) {
+
+    return scanner.findNameEnd(content.data(), content.size(), pos);
+}
+
+/*
+    Find the start of the next markup, i.e., the first '<', and count the newlines before it
+    in the same pass.
+
+    @param content View of the content
+    @param pos Position to start the search at
+    @param[out] newlines Number of '\n' characters from the position to the '<', or to the end when not found
+    @return Position of the first '<'
+    @retval std::string_view::npos Not found
+*/
+[[nodiscard]] std::size_t findTagStart(std::string_view content, std::size_t pos, std::size_t& newlines) {
+
+    return scanner.findTagStart(content.data(), content.size(), pos, newlines);
+}
+
+/*
+    Count the newlines in the characters with the instruction set.
+
+    @param characters View of the characters
+    @return Number of '\n' characters
+*/
+[[nodiscard]] std::size_t countNewlinesBlocks(std::string_view characters) {
+
+    return scanner.countNewlines(characters.data(), characters.size());
+}
+
+/*
+    Instruction set used for scanning
+
+    @return "avx2", "sse2", or "scalar"
+*/
+[[nodiscard]] std::string_view scanInstructionSet() {
+
+    return scanner.instructionSet;
+}
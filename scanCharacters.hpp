@@ -0,0 +1,81 @@
+/*
+    scanCharacters.hpp
+
+    Include file for scanning the content for structural characters.
+    Uses AVX2 or SSE2 when available, selected at runtime.
+*/
+
+#ifndef INCLUDED_SCANCHARACTERS_HPP
+#define INCLUDED_SCANCHARACTERS_HPP
+
+#include <string_view>
+#include <cstddef>
+
+/*
+    Find the end of character content, i.e., the first '<' or '&'.
+
+    @param content View of the content
+    @param pos Position to start the search at
+    @return Position of the first '<' or '&'
+    @retval std::string_view::npos Not found
+*/
+[[nodiscard]] std::size_t findCharacterEnd(std::string_view content, std::size_t pos = 0);
+
+/*
+    Find the end of a name, i.e., the first of "> /\":=" or whitespace.
+
+    @param content View of the content
+    @param pos Position to start the search at
+    @return Position of the first name end character
+    @retval std::string_view::npos Not found
+*/
+[[nodiscard]] std::size_t findNameEnd(std::string_view content, std::size_t pos = 0);
+
+/*
+    Find the start of the next markup, i.e., the first '<', and count the newlines before it
+    in the same pass.
+
+    @param content View of the content
+    @param pos Position to start the search at
+    @param[out] newlines Number of '\n' characters from the position to the '<', or to the end when not found
+    @return Position of the first '<'
+    @retval std::string_view::npos Not found
+*/
+[[nodiscard]] std::size_t findTagStart(std::string_view content, std::size_t pos, std::size_t& newlines);
+
+/*
+    Count the newlines in the characters with the instruction set.
+
+    @param characters View of the characters
+    @return Number of '\n' characters
+*/
+[[nodiscard]] std::size_t countNewlinesBlocks(std::string_view characters);
+
+/*
+    Count the newlines in the characters.
+
+    Short runs of characters, the common case in srcML, are counted
+    inline to avoid the cost of the call for the instruction set.
+
+    @param characters View of the characters
+    @return Number of '\n' characters
+*/
+[[nodiscard]] inline std::size_t countNewlines(std::string_view characters) {
+
+    if (characters.size() >= 32)
+        return countNewlinesBlocks(characters);
+
+    std::size_t count = 0;
+    for (const char c : characters)
+        count += c == '\n';
+    return count;
+}
+
+/*
+    Instruction set used for scanning
+
+    @return "avx2", "sse2", or "scalar"
+*/
+[[nodiscard]] std::string_view scanInstructionSet();
+
+#endif
@@ -0,0 +1,163 @@
+/*
+    splitArchive.cpp
+
+    Implementation file for splitting a srcML archive into its units
+*/
+
+#include "splitArchive.hpp"
+
+#include <algorithm>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+constexpr auto NAMEEND = "> /\":=\n\t\r"sv;
+constexpr auto WHITESPACE = " \n\t\r"sv;
+
+// characters that end the name of a tag
+constexpr auto TAGEND = "> /\n\t\r"sv;
+
+namespace {
+
+    // check if the text starts with the tag, i.e., "<" or "</" and the name, followed by the end of the name
+    [[nodiscard]] bool isTag(std::string_view text, std::string_view tag) {
+
+        return text.size() > tag.size() && text.compare(0, tag.size(), tag) == 0 && TAGEND.find(text[tag.size()]) != TAGEND.npos;
+    }
+}
+
+/*
+    Split a srcML archive at the top-level nested units of the root unit.
+
+    The root is a complete document, and each unit is a fragment of
+    element content. Nested units are only expected directly in the root,
+    as srcML archives do not nest them further.
+
+    @param document Entire srcML document
+    @param[out] parts Root and nested units of the archive
+    @return If the document is an archive with nested units
+*/
+[[nodiscard]] bool splitArchive(std::string_view document, ArchiveParts& parts) {
+
+    // find the root start tag, skipping the XML declaration, comments, and DOCTYPE
+    std::size_t rootStart = document.find('<');
+    while (rootStart != document.npos && rootStart + 1 < document.size() && (document[rootStart + 1] == '?' || document[rootStart + 1] == '!')) {
+        const auto endTag = document[rootStart + 1] == '?' ? "?>"sv : document.compare(rootStart, "<!--"sv.size(), "<!--"sv) == 0 ? "-->"sv : ">"sv;
+        const std::size_t tagEnd = document.find(endTag, rootStart);
+        if (tagEnd == document.npos)
+            return false;
+        rootStart = document.find('<', tagEnd);
+    }
+    if (rootStart == document.npos)
+        return false;
+
+    // root element name, including any prefix
+    const std::size_t nameEnd = document.find_first_of(NAMEEND, rootStart + 1);
+    if (nameEnd == document.npos)
+        return false;
+    const std::string_view qName(document.substr(rootStart + 1, nameEnd - (rootStart + 1)));
+    if (qName != "unit"sv && (qName.size() < ":unit"sv.size() || qName.substr(qName.size() - ":unit"sv.size()) != ":unit"sv))
+        return false;
+
+    // end of the root start tag, skipping over attribute values
+    std::size_t rootTagEnd = nameEnd;
+    while ((rootTagEnd = document.find_first_of(">\"'"sv, rootTagEnd)) != document.npos && document[rootTagEnd] != '>') {
+        rootTagEnd = document.find(document[rootTagEnd], rootTagEnd + 1);
+        if (rootTagEnd == document.npos)
+            return false;
+        ++rootTagEnd;
+    }
+    if (rootTagEnd == document.npos || document[rootTagEnd - 1] == '/')
+        return false;
+    ++rootTagEnd;
+
+    // start of each nested unit, and the root end tag, i.e., the last end tag of the root name.
+    // Comments, CDATA, and processing instructions are skipped, as their text can contain the tags
+    std::string startTag("<");
+    startTag += qName;
+    std::string endTag("</");
+    endTag += qName;
+    std::vector<std::size_t> unitStarts;
+    std::size_t rootEnd = document.npos;
+    for (std::size_t pos = document.find('<', rootTagEnd); pos != document.npos && pos + 1 < document.size(); pos = document.find('<', pos + 1)) {
+
+        // most tags are other elements, so only the first character of the name is checked for them
+        const char next = document[pos + 1];
+        if (next == '!' || next == '?') {
+            const auto skipEnd = next == '?' ? "?>"sv
+                               : document.compare(pos, "<![CDATA["sv.size(), "<![CDATA["sv) == 0 ? "]]>"sv
+                               : document.compare(pos, "<!--"sv.size(), "<!--"sv) == 0 ? "-->"sv : ">"sv;
+            pos = document.find(skipEnd, pos);
+            if (pos == document.npos)
+                return false;
+        } else if (next == '/') {
+            if (pos + 2 < document.size() && document[pos + 2] == endTag[2] && isTag(document.substr(pos), endTag))
+                rootEnd = pos;
+        } else if (next == startTag[1] && isTag(document.substr(pos), startTag)) {
+            unitStarts.push_back(pos);
+        }
+    }
+    if (rootEnd == document.npos)
+        return false;
+
+    // start tags after the root end tag are not units of the root
+    unitStarts.erase(std::lower_bound(unitStarts.begin(), unitStarts.end(), rootEnd), unitStarts.end());
+    if (unitStarts.empty())
+        return false;
+
+    // each unit extends to the start of the next unit, the last to the root end tag
+    parts.units.clear();
+    parts.units.reserve(unitStarts.size());
+    for (std::size_t i = 0; i < unitStarts.size(); ++i) {
+        const std::size_t unitEnd = i + 1 < unitStarts.size() ? unitStarts[i + 1] : rootEnd;
+        parts.units.push_back(document.substr(unitStarts[i], unitEnd - unitStarts[i]));
+    }
+
+    // namespace declarations and language of the root start tag, as the units use their prefixes,
+    // and a unit without a language attribute has the language of the root
+    parts.namespaces.clear();
+    parts.language = std::string_view();
+    const std::string_view rootTag(document.substr(nameEnd, rootTagEnd - nameEnd));
+    for (std::size_t pos = rootTag.find_first_not_of(WHITESPACE); pos != rootTag.npos; pos = rootTag.find_first_not_of(WHITESPACE, pos)) {
+        const std::size_t equalPosition = rootTag.find('=', pos);
+        const std::size_t valueStart = equalPosition == rootTag.npos ? rootTag.npos : rootTag.find_first_of("\"'"sv, equalPosition);
+        if (valueStart == rootTag.npos)
+            break;
+        const std::size_t valueEnd = rootTag.find(rootTag[valueStart], valueStart + 1);
+        if (valueEnd == rootTag.npos)
+            break;
+        std::string_view name(rootTag.substr(pos, equalPosition - pos));
+        name = name.substr(0, name.find_first_of(WHITESPACE));
+        const std::string_view value(rootTag.substr(valueStart + 1, valueEnd - (valueStart + 1)));
+        if (name == "xmlns"sv)
+            parts.namespaces.emplace_back(std::string_view(), value);
+        else if (name.substr(0, "xmlns:"sv.size()) == "xmlns:"sv)
+            parts.namespaces.emplace_back(name.substr("xmlns:"sv.size()), value);
+        else if (name == "language"sv)
+            parts.language = value;
+        pos = valueEnd + 1;
+    }
+
+    // root without the units
+    parts.root.assign(document.substr(0, unitStarts.front()));
+    parts.root.append(document.substr(rootEnd));
+
+    return true;
+}
+
+/*
+    Offset in the document of an offset in the root of an archive,
+    e.g., for the position of a parse error in the root
+
+    @param document Entire srcML document
+    @param parts Root and nested units of the archive
+    @param rootOffset Offset in the root
+    @return Offset in the document
+*/
+[[nodiscard]] long long rootToDocumentOffset(std::string_view document, const ArchiveParts& parts, long long rootOffset) {
+
+    // root is the document before the first unit, then the document after the last unit
+    const long long firstUnitStart = parts.units.front().data() - document.data();
+    const long long lastUnitEnd = parts.units.back().data() + parts.units.back().size() - document.data();
+    return rootOffset < firstUnitStart ? rootOffset : rootOffset - firstUnitStart + lastUnitEnd;
+}
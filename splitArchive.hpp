@@ -0,0 +1,56 @@
+/*
+    splitArchive.hpp
+
+    Include file for splitting a srcML archive into its units
+*/
+
+#ifndef INCLUDED_SPLITARCHIVE_HPP
+#define INCLUDED_SPLITARCHIVE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+
+// parts of a srcML archive that can be parsed independently
+struct ArchiveParts {
+
+    // document without the nested units, i.e., XML declaration, root start tag,
+    // content before the first unit, and root end tag
+    std::string root;
+
+    // each nested unit with the content that follows it up to the next unit
+    std::vector<std::string_view> units;
+
+    // namespace declarations of the root start tag as prefix and URI, for the parsers of the units
+    std::vector<std::pair<std::string_view, std::string_view>> namespaces;
+
+    // language attribute of the root start tag, empty if none
+    std::string_view language;
+};
+
+/*
+    Split a srcML archive at the top-level nested units of the root unit.
+
+    The root is a complete document, and each unit is a fragment of
+    element content. Nested units are only expected directly in the root,
+    as srcML archives do not nest them further.
+
+    @param document Entire srcML document
+    @param[out] parts Root and nested units of the archive
+    @return If the document is an archive with nested units
+*/
+[[nodiscard]] bool splitArchive(std::string_view document, ArchiveParts& parts);
+
+/*
+    Offset in the document of an offset in the root of an archive,
+    e.g., for the position of a parse error in the root
+
+    @param document Entire srcML document
+    @param parts Root and nested units of the archive
+    @param rootOffset Offset in the root
+    @return Offset in the document
+*/
+[[nodiscard]] long long rootToDocumentOffset(std::string_view document, const ArchiveParts& parts, long long rootOffset);
+
+#endif
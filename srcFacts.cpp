@@ -4,7 +4,11 @@
     Produces a report with various measures of source code.
     Supports C++, C, Java, and C#. Input is an XML file in the srcML format,
     and output is a markdown table with the measures. Performance statistics
-    are output to standard error.
+    are output to standard error. Optionally, the measures of each unit
+    are streamed to a CSV or JSON Lines file. Many input files, or glob
+    patterns, are parsed in parallel, with a report for each file and for
+    all the files. As a server, the reports are for the documents of
+    requests on a Unix domain socket.
     The code includes a complete XML parser:
     * Characters and content from XML is in UTF-8
     * DTD declarations are allowed, but not fine-grained parsed
@@ -26,48 +30,202 @@
 #include <stdlib.h>
 #include <bitset>
 #include <cassert>
+#include <thread>
+#include <vector>
 
-#include "refillContent.hpp"
+#include "InputSource.hpp"
+#include "ReadInputSource.hpp"
+#include "MMapInputSource.hpp"
+#include "MemoryInputSource.hpp"
+#include "DecompressInputSource.hpp"
 #include "XMLParser.hpp"
 #include "srcFactsParser.hpp"
+#include "parseArchiveParallel.hpp"
+#include "UnitReport.hpp"
+#include "srcFactsReport.hpp"
+#include "srcFactsServer.hpp"
+#include "parseFilesParallel.hpp"
+#include "WholeDocument.hpp"
+#include "inputFiles.hpp"
+
+#if !defined(_MSC_VER)
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
 
 int main(int argc, char* argv[]) {
 
+    // number of worker threads, with 1 for a serial parse and 0 for all cores
+    int jobs = 1;
+    InputMode mode = InputMode::AUTO;
+    Tokenizer tokenizer = Tokenizer::SCAN;
+    // file for the report of each unit, none if empty
+    std::string_view unitsPath;
+    // socket of the server, none if empty
+    std::string_view socketPath;
+    // input files and glob patterns, with standard input if none
+    std::vector<std::string_view> inputArguments;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if ((arg == "-j"sv || arg == "--jobs"sv) && i + 1 < argc) {
+            jobs = atoi(argv[++i]);
+        } else if (arg == "--input"sv && i + 1 < argc && parseInputMode(argv[i + 1], mode)) {
+            ++i;
+        } else if (arg == "--tokenizer"sv && i + 1 < argc && (argv[i + 1] == "scan"sv || argv[i + 1] == "index"sv)) {
+            tokenizer = argv[++i] == "index"sv ? Tokenizer::INDEX : Tokenizer::SCAN;
+        } else if (arg == "--units"sv && i + 1 < argc) {
+            unitsPath = argv[++i];
+        } else if (arg == "--server"sv && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (!arg.empty() && arg[0] != '-') {
+            inputArguments.push_back(arg);
+        } else {
+            std::cerr << "usage: srcfacts [-j jobs] [--input mmap|read|read-ahead|io_uring] [--tokenizer scan|index] [--units units.csv|units.jsonl] [--server socket] [file.xml ...] < file.xml\n";
+            return 1;
+        }
+    }
+    if (jobs < 1)
+        jobs = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    // server has a pool of jobs workers, each parsing the documents of its connection
+    if (!socketPath.empty())
+        return srcFactsServer(std::string(socketPath).c_str(), jobs, tokenizer);
+
+    std::vector<std::string> paths;
+    std::string unmatched;
+    if (!expandInputFiles(inputArguments, paths, unmatched)) {
+        std::cerr << "srcfacts error : No files match '" << unmatched << "'\n";
+        return 1;
+    }
+
     const auto startTime = std::chrono::steady_clock::now();
 
     srcFactsParser handler;
-    XMLParser parser(handler);
 
-    parser.parse();
+    // rows of the units are streamed to the file as the units end
+    std::unique_ptr<UnitReport> unitReport;
+    int unitsFD = -1;
+    if (!unitsPath.empty()) {
+#if !defined(_MSC_VER)
+        unitsFD = open(std::string(unitsPath).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#else
+        unitsFD = _open(std::string(unitsPath).c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#endif
+        if (unitsFD == -1) {
+            std::cerr << "srcfacts error : Unable to open units file '" << unitsPath << "'\n";
+            return 1;
+        }
+        unitReport = std::make_unique<UnitReport>(unitsFD, UnitReport::formatOf(unitsPath));
+        handler.setUnitReport(unitReport.get());
+    }
+    long long totalBytes = 0;
+    std::string inputMode;
+
+    // a parse error of the standard input ends srcfacts with its message
+    XMLParseError error;
+
+    // each input file has its own counts and error, with the counts of the files without an error merged
+    std::vector<FileFacts> files(paths.size());
+    int failedFiles = 0;
+    // number of source files, i.e., the nested units of an archive, or the unit of a single source file
+    long long fileCount = 0;
+    if (!files.empty()) {
+        for (std::size_t i = 0; i < files.size(); ++i)
+            files[i].path = paths[i];
+
+        parseFilesParallel(files, jobs, tokenizer, unitReport.get());
+
+        for (auto& file : files) {
+            if (file.error) {
+                std::cerr << file.path << ": " << file.error.message << '\n';
+                ++failedFiles;
+                continue;
+            }
+            handler.merge(file.handler);
+            totalBytes += file.totalBytes;
+            fileCount += std::max(file.handler.getUnitCount() - 1, 1LL);
+        }
+        inputMode = std::to_string(files.size()) + " files, " + std::to_string(jobs) + " jobs";
+    } else if (jobs == 1) {
+        auto input = makeInputSource(0, DEFAULT_BUFFER_SIZE, mode);
+        BasicXMLParser<srcFactsParser> parser(handler, *input, tokenizer);
+
+        error = parser.parse();
+
+        totalBytes = parser.getTotalBytes();
+        inputMode = input->mode();
+    } else {
+
+        // parallel parse needs the entire document in memory, decompressed
+        WholeDocument wholeDocument(0);
+        if (!wholeDocument.isLoaded()) {
+            std::cerr << wholeDocument.error() << '\n';
+            return 1;
+        }
+        const std::string_view document = wholeDocument.view();
+
+        // serial parse when the document is not an archive of units
+        if (!parseArchiveParallel(document, handler, error, jobs, tokenizer)) {
+            MemoryInputSource input(document);
+            BasicXMLParser<srcFactsParser> parser(handler, input, tokenizer);
+            error = parser.parse();
+        }
+
+        totalBytes = static_cast<long long>(document.size());
+        inputMode = std::string(wholeDocument.mode()) + ", " + std::to_string(jobs) + " jobs";
+    }
+    if (error) {
+        std::cerr << error.message << '\n';
+        return 1;
+    }
+
+    // remaining rows of the units are written
+    long long reportedUnits = 0;
+    if (unitReport) {
+        reportedUnits = unitReport->getUnitCount();
+        unitReport.reset();
+#if !defined(_MSC_VER)
+        close(unitsFD);
+#else
+        _close(unitsFD);
+#endif
+    }
 
     const auto finishTime = std::chrono::steady_clock::now();
     const auto elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count();
     const double MLOCPerSecond = handler.getLOC() / elapsedSeconds / 1000000;
-    int files = std::max(handler.getUnitCount() - 1, 1);
     std::cout.imbue(std::locale{""});
-    int valueWidth = std::max(5, static_cast<int>(log10(parser.getTotalBytes()) * 1.3 + 1));
-
-    // output Report
-    std::cout << "# srcFacts: " << handler.getURL() << '\n';
-    std::cout << "| Measure       | " << std::setw(valueWidth + 3) << "Value |\n";
-    std::cout << "|:--------------|-" << std::setw(valueWidth + 3) << std::setfill('-') << ":|\n" << std::setfill(' ');
-    std::cout << "| Characters    | " << std::setw(valueWidth) << handler.getTextsize()         << " |\n";
-    std::cout << "| LOC           | " << std::setw(valueWidth) << handler.getLOC()              << " |\n";
-    std::cout << "| Files         | " << std::setw(valueWidth) << files                         << " |\n";
-    std::cout << "| Classes       | " << std::setw(valueWidth) << handler.getClassCount()       << " |\n";
-    std::cout << "| Functions     | " << std::setw(valueWidth) << handler.getFunctionCount()    << " |\n";
-    std::cout << "| Declarations  | " << std::setw(valueWidth) << handler.getDeclCount()        << " |\n";
-    std::cout << "| Expressions   | " << std::setw(valueWidth) << handler.getExprCount()        << " |\n";
-    std::cout << "| Comments      | " << std::setw(valueWidth) << handler.getCommentCount()     << " |\n";
-    std::cout << "| Returns       | " << std::setw(valueWidth) << handler.getReturnCount()      << " |\n";
-    std::cout << "| Line Comments | " << std::setw(valueWidth) << handler.getLineCommentCount() << " |\n";
-    std::cout << "| Strings       | " << std::setw(valueWidth) << handler.getLiteralCount()     << " |\n";
+    if (files.empty())
+        srcFactsReport(std::cout, handler, totalBytes, handler.getURL(), std::max(handler.getUnitCount() - 1, 1LL));
+
+    // report of each file, then of all the files
+    std::string_view separator;
+    for (auto& file : files) {
+        if (file.error)
+            continue;
+        std::cout << separator;
+        separator = "\n"sv;
+        srcFactsReport(std::cout, file.handler, file.totalBytes, file.path, std::max(file.handler.getUnitCount() - 1, 1LL));
+    }
+    if (files.size() > 1) {
+        std::cout << separator;
+        srcFactsReport(std::cout, handler, totalBytes, std::to_string(files.size() - failedFiles) + " files", fileCount);
+    }
     std::clog.imbue(std::locale{""});
     std::clog.precision(3);
     std::clog << '\n';
-    std::clog << parser.getTotalBytes()  << " bytes\n";
+    std::clog << totalBytes  << " bytes\n";
     std::clog << elapsedSeconds << " sec\n";
+    std::clog << static_cast<long long>(totalBytes / elapsedSeconds) << " bytes/sec (" << inputMode << ")\n";
     std::clog << MLOCPerSecond << " MLOC/sec\n";
+    if (!unitsPath.empty())
+        std::clog << reportedUnits << " units (" << unitsPath << ")\n";
 
-    return 0;
+    return failedFiles ? 1 : 0;
 }
@@ -5,82 +5,298 @@
 */
 
 #include "srcFactsParser.hpp"
-#include <algorithm>
+#include "scanCharacters.hpp"
+#include "XMLParserImpl.hpp"
 
 // provides literal string operator""sv
 using namespace std::literals::string_view_literals;
 
-srcFactsParser::srcFactsParser() {}
+// XML parser with direct calls to the srcFactsParser
+template class BasicXMLParser<srcFactsParser>;
 
-void srcFactsParser::handleStartDocument() {}
+srcFactsParser::srcFactsParser(bool batched) : batched(batched) {}
 
-void srcFactsParser::handleDeclaration(std::string_view version, std::optional<std::string_view> encoding, std::optional<std::string_view> standalone) {}
+unsigned int srcFactsParser::events() const {
 
-void srcFactsParser::handleDOCTYPE() {}
+    return (batched ? BATCH : 0U) | START_TAG | END_TAG | ATTRIBUTE | CDATA | CHARACTER_ENTITY_REFERENCES | CHARACTER_NON_ENTITY_REFERENCES;
+}
 
-void srcFactsParser::handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+XMLParserHandler::Directive srcFactsParser::handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) {
 
-    if (localName == "expr"sv) {
-        ++exprCount;
-    } else if (localName == "decl"sv) {
-        ++declCount;
-    } else if (localName == "comment"sv) {
-        ++commentCount;
-    } else if (localName == "function"sv) {
-        ++functionCount;
-    } else if (localName == "unit"sv) {
-        ++unitCount;
-    } else if (localName == "class"sv) {
-        ++classCount;
-    } else if (localName == "return"sv) {
-        ++returnCount;
-    }
+    if (nameID == NameTable::UNIT)
+        startUnit();
+
+    // names that are not srcML do not have a count
+    if (nameID < NameTable::SRCML_NAME_COUNT)
+        ++counts.tagCounts[nameID];
+
+    return CONTINUE;
 }
 
-void srcFactsParser::handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) {}
+void srcFactsParser::handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) {
 
-void srcFactsParser::handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) {
+    if (nameID == NameTable::UNIT)
+        endUnit();
+}
+
+void srcFactsParser::handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value, int nameID) {
 
     bool inEscape = localName == "escape"sv;
-    if (localName == "url"sv)
+    if (nameID == NameTable::URL)
         url = value;
+    if (nameID == NameTable::FILENAME && unitReport)
+        unitFilename = value;
+    if (nameID == NameTable::LANGUAGE)
+        setUnitLanguage(internLanguage(value));
     // convert special srcML escaped element to characters
     if (inEscape && localName == "char"sv /* && inUnit */) {
         // use strtol() instead of atoi() since strtol() understands hex encoding of '0x0?'
         [[maybe_unused]] char escapeValue = (char)strtol(value.data(), NULL, 0);
     }
     if(value == "line"sv) {
-        ++lineCommentCount;
+        ++counts.lineCommentCount;
     }
     if(value == "string"sv) {
-        ++literalCount;
+        ++counts.literalCount;
     }
 }
 
-void srcFactsParser::handleNamespace(std::string_view prefix, std::string_view uri) {}
-
-void srcFactsParser::handleComment(std::string_view comment) {}
-
 void srcFactsParser::handleCDATA(std::string_view characters) {
 
-    textSize += static_cast<int>(characters.size());
-    loc += static_cast<int>(std::count(characters.cbegin(), characters.cend(), '\n'));
+    counts.textSize += static_cast<long long>(characters.size());
+    counts.loc += static_cast<long long>(countNewlines(characters));
 }
 
-void srcFactsParser::handleProcessingInstruction(std::string_view target, std::string_view data) {}
-
 void srcFactsParser::handleCharacterEntityReferences(std::string_view characters) {
 
-    ++textSize;
+    ++counts.textSize;
 }
 
 void srcFactsParser::handleCharacterNonEntityReferences(std::string_view characters) {
 
-    loc += static_cast<int>(std::count(characters.cbegin(), characters.cend(), '\n'));
-    textSize += static_cast<int>(characters.size());
+    counts.loc += static_cast<long long>(countNewlines(characters));
+    counts.textSize += static_cast<long long>(characters.size());
+}
+
+// count the events of the batch in one loop, the same as the handler methods for each event
+void srcFactsParser::handleBatch(const EventBatch& batch) {
+
+    for (std::size_t event = 0; event < batch.size; ++event) {
+        const int nameID = batch.nameIDs[event];
+        switch (batch.kinds[event]) {
+        case START_TAG:
+
+            if (nameID == NameTable::UNIT)
+                startUnit();
+
+            // names that are not srcML do not have a count
+            if (nameID < NameTable::SRCML_NAME_COUNT)
+                ++counts.tagCounts[nameID];
+            break;
+        case END_TAG:
+            if (nameID == NameTable::UNIT)
+                endUnit();
+            break;
+        case ATTRIBUTE: {
+            const std::string_view value(batch.text(event));
+            if (nameID == NameTable::URL)
+                url = value;
+            if (nameID == NameTable::FILENAME && unitReport)
+                unitFilename = value;
+            if (nameID == NameTable::LANGUAGE)
+                setUnitLanguage(internLanguage(value));
+            if (value == "line"sv)
+                ++counts.lineCommentCount;
+            if (value == "string"sv)
+                ++counts.literalCount;
+            break;
+        }
+        case CHARACTER_ENTITY_REFERENCES:
+
+            // each reference is one character
+            ++counts.textSize;
+            break;
+        case CDATA:
+        case CHARACTER_NON_ENTITY_REFERENCES: {
+            const std::string_view characters(batch.text(event));
+            counts.textSize += static_cast<long long>(characters.size());
+            counts.loc += static_cast<long long>(countNewlines(characters));
+            break;
+        }
+        }
+    }
+}
+
+// add the counts of another block
+srcFactsParser::Counts& srcFactsParser::Counts::operator+=(const Counts& other) {
+
+    textSize += other.textSize;
+    loc += other.loc;
+    for (int nameID = 0; nameID < NameTable::SRCML_NAME_COUNT; ++nameID)
+        tagCounts[nameID] += other.tagCounts[nameID];
+    lineCommentCount += other.lineCommentCount;
+    literalCount += other.literalCount;
+    return *this;
+}
+
+// language ID of the language name, with a new language added
+[[nodiscard]] int srcFactsParser::internLanguage(std::string_view name) {
+
+    for (int languageID = 1; languageID < languageCount; ++languageID) {
+        if (languages[languageID] == name)
+            return languageID;
+    }
+
+    // languages past the maximum are counted with no language
+    if (languageCount == MAX_LANGUAGES)
+        return 0;
+
+    languages[languageCount] = name;
+    return languageCount++;
+}
+
+// add the counts since the last start of a unit to the block of the current language
+void srcFactsParser::flushCounts() {
+
+    languageCounts[language] += counts;
+    counts = Counts();
+}
+
+// measures of a block of counts
+[[nodiscard]] UnitCounts srcFactsParser::measures(const Counts& counts) {
+
+    UnitCounts measures;
+    measures.characters = counts.textSize;
+    measures.loc = counts.loc;
+    measures.classes = counts.tagCounts[NameTable::CLASS];
+    measures.functions = counts.tagCounts[NameTable::FUNCTION];
+    measures.declarations = counts.tagCounts[NameTable::DECL];
+    measures.expressions = counts.tagCounts[NameTable::EXPR];
+    measures.comments = counts.tagCounts[NameTable::COMMENT];
+    measures.returns = counts.tagCounts[NameTable::RETURN];
+    measures.lineComments = counts.lineCommentCount;
+    measures.strings = counts.literalCount;
+    return measures;
+}
+
+// counts of all languages
+[[nodiscard]] srcFactsParser::Counts srcFactsParser::totalCounts() const {
+
+    Counts total = counts;
+    for (int languageID = 0; languageID < languageCount; ++languageID)
+        total += languageCounts[languageID];
+    return total;
+}
+
+// start of a unit, with the counts since the previous start in the block of its language
+void srcFactsParser::startUnit() {
+
+    // a unit has the language of the enclosing unit until its language attribute
+    flushCounts();
+    language = unitLanguages.empty() ? rootLanguage : unitLanguages.back();
+    unitLanguages.push_back(language);
+    ++unitDepth;
+    leafUnitDepth = unitDepth;
+    if (unitReport)
+        unitFilename.clear();
+}
+
+// end of a unit, with the row of a unit without nested units reported
+void srcFactsParser::endUnit() {
+
+    // counts since the start of a unit without nested units are the counts of the unit
+    if (unitReport && unitDepth == leafUnitDepth) {
+        unitReport->write(unitFilename, languages[language], measures(counts));
+
+        // enclosing units have nested units
+        leafUnitDepth = 0;
+    }
+    --unitDepth;
+
+    // the language of the unit stays until the next start of a unit, for the content after its end
+    if (!unitLanguages.empty())
+        unitLanguages.pop_back();
 }
 
-void srcFactsParser::handleEndDocument() {}
+// language of the current unit, from its language attribute
+void srcFactsParser::setUnitLanguage(int languageID) {
+
+    language = languageID;
+    if (!unitLanguages.empty())
+        unitLanguages.back() = languageID;
+}
+
+// language of the enclosing unit of the units parsed as fragments
+void srcFactsParser::setRootLanguage(std::string_view name) {
+
+    rootLanguage = name.empty() ? 0 : internLanguage(name);
+}
+
+// report the counts of each unit as it ends
+void srcFactsParser::setUnitReport(UnitReport* report) {
+
+    unitReport = report;
+}
+
+// get method for unitReport
+UnitReport* srcFactsParser::getUnitReport() {
+
+    return unitReport;
+}
+
+// clear the counts and languages, with the unit report kept
+void srcFactsParser::reset() {
+
+    url.clear();
+    counts = Counts();
+    languageCounts.fill(Counts());
+    languageCount = 1;
+    language = 0;
+    unitLanguages.clear();
+    rootLanguage = 0;
+    unitDepth = 0;
+    leafUnitDepth = 0;
+    unitFilename.clear();
+}
+
+// add the counts of another handler
+void srcFactsParser::merge(const srcFactsParser& other) {
+
+    if (url.empty())
+        url = other.url;
+
+    // language IDs are by name, as each handler adds languages in the order they are found
+    for (int languageID = 0; languageID < other.languageCount; ++languageID)
+        languageCounts[languageID ? internLanguage(other.languages[languageID]) : 0] += other.languageCounts[languageID];
+    languageCounts[other.language ? internLanguage(other.languages[other.language]) : 0] += other.counts;
+}
+
+// get method for the number of language IDs
+int srcFactsParser::getLanguageCount() {
+
+    return languageCount;
+}
+
+// get method for the name of a language
+std::string_view srcFactsParser::getLanguage(int languageID) {
+
+    return languages[languageID];
+}
+
+// get method for the measures of a language
+UnitCounts srcFactsParser::getLanguageCounts(int languageID) {
+
+    Counts total = languageCounts[languageID];
+    if (languageID == language)
+        total += counts;
+    return measures(total);
+}
+
+// get method for the number of units of a language
+long long srcFactsParser::getLanguageUnitCount(int languageID) {
+
+    return languageCounts[languageID].tagCounts[NameTable::UNIT] + (languageID == language ? counts.tagCounts[NameTable::UNIT] : 0);
+}
 
 // get method for URL
 std::string srcFactsParser::getURL() {
@@ -89,67 +305,67 @@ std::string srcFactsParser::getURL() {
 }
 
 //get method for textsize
-int srcFactsParser::getTextsize() {
+long long srcFactsParser::getTextsize() {
 
-    return textSize;
+    return totalCounts().textSize;
 }
 
 //get method for loc
-int srcFactsParser::getLOC() {
+long long srcFactsParser::getLOC() {
 
-    return loc;
+    return totalCounts().loc;
 }
 
 //get method for exprCount
-int srcFactsParser::getExprCount() {
+long long srcFactsParser::getExprCount() {
 
-    return exprCount;
+    return totalCounts().tagCounts[NameTable::EXPR];
 }
 
 //get method for functionCount
-int srcFactsParser::getFunctionCount() {
+long long srcFactsParser::getFunctionCount() {
 
-    return functionCount;
+    return totalCounts().tagCounts[NameTable::FUNCTION];
 }
 
 //get method for classCount
-int srcFactsParser::getClassCount() {
+long long srcFactsParser::getClassCount() {
     
-    return classCount;
+    return totalCounts().tagCounts[NameTable::CLASS];
 }
 
 //get method for unitCount
-int srcFactsParser::getUnitCount() {
+long long srcFactsParser::getUnitCount() {
 
-    return unitCount;
+    return totalCounts().tagCounts[NameTable::UNIT];
 }
 
 //get method for declCount
-int srcFactsParser::getDeclCount() {
+long long srcFactsParser::getDeclCount() {
 
-    return declCount;
+    return totalCounts().tagCounts[NameTable::DECL];
 }
 
 //get method for commentCount
-int srcFactsParser::getCommentCount() {
+long long srcFactsParser::getCommentCount() {
 
-    return commentCount;
+    return totalCounts().tagCounts[NameTable::COMMENT];
 }
 
 //get method for returnCount
-int srcFactsParser::getReturnCount() {
+long long srcFactsParser::getReturnCount() {
 
-    return returnCount;
+    return totalCounts().tagCounts[NameTable::RETURN];
 }
 
 //get method for lineCommentCount
-int srcFactsParser::getLineCommentCount() {
+long long srcFactsParser::getLineCommentCount() {
 
-    return lineCommentCount;
+    return totalCounts().lineCommentCount;
 }
 
 //get method for literalCount
-int srcFactsParser::getLiteralCount() {
+long long srcFactsParser::getLiteralCount() {
 
-    return literalCount;
+    return totalCounts().literalCount;
 }
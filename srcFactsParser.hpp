@@ -8,92 +8,202 @@
 #define INCLUDED_SRCFACTSPARSER_HPP
 
 #include "XMLParserHandler.hpp"
+#include "XMLParser.hpp"
+#include "NameTable.hpp"
+#include "UnitReport.hpp"
 
 #include <string>
+#include <string_view>
+#include <array>
+#include <vector>
 
-class srcFactsParser : public XMLParserHandler {
+class srcFactsParser final : public XMLParserHandler {
+
+    public:
+
+    // maximum number of language IDs, including no language
+    static constexpr int MAX_LANGUAGES = 16;
 
     private:
+
+    // parser calls the handler methods directly
+    template <typename Handler>
+    friend class BasicXMLParser;
     
+    // counts of the measures
+    struct Counts {
+        long long textSize = 0;
+        long long loc = 0;
+        // count of each srcML start tag, indexed by name ID
+        std::array<long long, NameTable::SRCML_NAME_COUNT> tagCounts{};
+        long long lineCommentCount = 0;
+        long long literalCount = 0;
+
+        // add the counts of another block
+        Counts& operator+=(const Counts& other);
+    };
+
     std::string url;
-    int textSize = 0;
-    int loc = 0;
-    int exprCount = 0;
-    int functionCount = 0;
-    int classCount = 0;
-    int unitCount = 0;
-    int declCount = 0;
-    int commentCount = 0;
-    int returnCount = 0;
-    int lineCommentCount = 0;
-    int literalCount = 0;
 
-    // Override function for handlers
-    void handleStartDocument() override;
+    // counts since the last start of a unit, then added to the block of its language.
+    // The counts are only added at the start of a unit, so the content after the end of a
+    // nested unit, i.e., the whitespace between the units of an archive, is in the block
+    // of the language of that unit
+    Counts counts;
 
-    void handleDeclaration(std::string_view version, std::optional<std::string_view> encoding, std::optional<std::string_view> standalone) override;
+    // block of counts for each language, indexed by language ID, with 0 for no language
+    std::array<Counts, MAX_LANGUAGES> languageCounts{};
 
-    void handleDOCTYPE() override;
+    // name of each language, indexed by language ID
+    std::array<std::string, MAX_LANGUAGES> languages{};
 
-    void handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+    // number of language IDs, including no language
+    int languageCount = 1;
 
-    void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+    // language ID of the current unit
+    int language = 0;
 
-    void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) override;
+    // language ID of each open unit, as a unit without a language attribute has the language of its enclosing unit
+    std::vector<int> unitLanguages;
 
-    void handleNamespace(std::string_view prefix, std::string_view uri) override;
+    // language ID of the enclosing unit of the outermost units, e.g., the root unit for the units of an archive
+    int rootLanguage = 0;
 
-    void handleComment(std::string_view comment) override;
+    // events are consumed in batches
+    bool batched;
 
-    void handleCDATA(std::string_view characters) override;
+    // report of each unit, nullptr if none
+    UnitReport* unitReport = nullptr;
+
+    // depth of the current unit, with 1 for the root unit
+    int unitDepth = 0;
+
+    // depth of the unit without nested units so far, 0 if none
+    int leafUnitDepth = 0;
+
+    // filename of the current unit
+    std::string unitFilename;
+
+    // language ID of the language name, with a new language added
+    [[nodiscard]] int internLanguage(std::string_view name);
+
+    // add the counts since the last start of a unit to the block of the current language
+    void flushCounts();
+
+    // measures of a block of counts
+    [[nodiscard]] static UnitCounts measures(const Counts& counts);
+
+    // counts of all languages
+    [[nodiscard]] Counts totalCounts() const;
+
+    // start of a unit, with the counts since the previous start in the block of its language
+    void startUnit();
+
+    // end of a unit, with the row of a unit without nested units reported
+    void endUnit();
+
+    // language of the current unit, from its language attribute
+    void setUnitLanguage(int languageID);
+
+    // Events used, so the parser skips namespaces
+    unsigned int events() const override;
 
-    void handleProcessingInstruction(std::string_view target, std::string_view data) override;
+    // Override function for handlers, other events are not used
+    Directive handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) override;
+
+    void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName, int nameID) override;
+
+    void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value, int nameID) override;
+
+    void handleCDATA(std::string_view characters) override;
 
     void handleCharacterEntityReferences(std::string_view characters) override;
 
     void handleCharacterNonEntityReferences(std::string_view characters) override;
 
-    void handleEndDocument() override;
+    // All of the used events in a batch, with one handler call for the batch
+    void handleBatch(const EventBatch& batch) override;
 
     public:
 
-    srcFactsParser();
+    /*
+        Constructor
+
+        @param batched Consume the events in batches, instead of a handler call for each event,
+                       e.g., with the virtual calls of the XMLParser
+    */
+    explicit srcFactsParser(bool batched = false);
+
+    /*
+        Report the counts of each unit as it ends. Units without nested units
+        are reported, i.e., the nested units of an archive, or a single root unit.
+
+        @param report Report for the units, nullptr for none
+    */
+    void setUnitReport(UnitReport* report);
+
+    // Get method for unitReport
+    UnitReport* getUnitReport();
+
+    // Clear the counts and languages, e.g., to reuse the handler for another document
+    void reset();
+
+    // Add the counts of another handler, e.g., from a parallel parse
+    void merge(const srcFactsParser& other);
+
+    // Set the language of the enclosing unit of the units parsed as fragments, e.g., the language attribute of the root unit
+    void setRootLanguage(std::string_view name);
+
+    // Get method for the number of language IDs, with 0 for no language
+    int getLanguageCount();
+
+    // Get method for the name of a language
+    std::string_view getLanguage(int languageID);
+
+    // Get method for the measures of a language
+    UnitCounts getLanguageCounts(int languageID);
+
+    // Get method for the number of units of a language
+    long long getLanguageUnitCount(int languageID);
 
     // Get method for URL
     std::string getURL();
 
     // Get method for textsize
-    int getTextsize();
+    long long getTextsize();
 
     // Get method for LOC
-    int getLOC();
+    long long getLOC();
 
     // Get method for exprCount
-    int getExprCount();
+    long long getExprCount();
 
     // Get method for functionCount
-    int getFunctionCount();
+    long long getFunctionCount();
 
     // Get method for classCount
-    int getClassCount();
+    long long getClassCount();
 
     // Get method for unitCount
-    int getUnitCount();
+    long long getUnitCount();
 
     // Get method for declCount
-    int getDeclCount();
+    long long getDeclCount();
 
     // Get method for commentCount
-    int getCommentCount();
+    long long getCommentCount();
 
     // Get method for returnCount
-    int getReturnCount();
+    long long getReturnCount();
 
     // Get method for lineCommentCount
-    int getLineCommentCount();
+    long long getLineCommentCount();
 
     // Get method for literalCount
-    int getLiteralCount();
+    long long getLiteralCount();
 };
 
+// XML parser with direct calls to the srcFactsParser, instantiated in srcFactsParser.cpp
+extern template class BasicXMLParser<srcFactsParser>;
+
 #endif
@@ -0,0 +1,94 @@
+/*
+    srcFactsReport.cpp
+
+    Implementation file for the markdown report of the srcFacts measures
+*/
+
+#include "srcFactsReport.hpp"
+
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+/*
+    Output the measures as a markdown table, with a column for each language
+
+    @param out Stream for the report, imbued with the locale of the numbers
+    @param handler Handler with the counts of the document
+    @param totalBytes Size of the document, for the width of the values
+    @param title Title of the report, e.g., the URL of the archive
+    @param files Number of source files, e.g., the units of an archive without the root unit
+*/
+void srcFactsReport(std::ostream& out, srcFactsParser& handler, long long totalBytes, std::string_view title, long long files) {
+
+    int valueWidth = std::max(5, static_cast<int>(log10(std::max(totalBytes, 1LL)) * 1.3 + 1));
+
+    // column for each language after the value, as wide as the value or the language name
+    struct LanguageColumn {
+        std::string name;
+        int width;
+        long long files;
+        UnitCounts counts;
+    };
+    std::vector<LanguageColumn> languageColumns;
+    for (int languageID = 1; languageID < handler.getLanguageCount(); ++languageID) {
+        const std::string name(handler.getLanguage(languageID));
+        languageColumns.push_back({ name, std::max(valueWidth, static_cast<int>(name.size())),
+                                    handler.getLanguageUnitCount(languageID), handler.getLanguageCounts(languageID) });
+    }
+
+    // languages are in the order found, which differs for a parallel parse
+    std::sort(languageColumns.begin(), languageColumns.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+
+    // counts in no language, e.g., the text of an archive outside of its units, in a last column
+    // when there are any, so that the language columns add up to the value. The units that are
+    // not files, e.g., the root unit of an archive, are not in its files
+    const UnitCounts noneCounts = handler.getLanguageCounts(0);
+    const long long noneFiles = std::max(0LL, handler.getLanguageUnitCount(0) - (handler.getUnitCount() - files));
+    if (noneFiles || noneCounts.characters || noneCounts.loc || noneCounts.classes || noneCounts.functions || noneCounts.declarations
+        || noneCounts.expressions || noneCounts.comments || noneCounts.returns || noneCounts.lineComments || noneCounts.strings)
+        languageColumns.push_back({ "None", std::max(valueWidth, static_cast<int>("None"sv.size())), noneFiles, noneCounts });
+
+    // rows of the report, with the measure of the language columns, or files when none
+    struct Row {
+        std::string_view measure;
+        long long value;
+        long long UnitCounts::* languageMeasure;
+    };
+    const Row rows[] = {
+        { "Characters   "sv, handler.getTextsize(),         &UnitCounts::characters },
+        { "LOC          "sv, handler.getLOC(),              &UnitCounts::loc },
+        { "Files        "sv, files,                         nullptr },
+        { "Classes      "sv, handler.getClassCount(),       &UnitCounts::classes },
+        { "Functions    "sv, handler.getFunctionCount(),    &UnitCounts::functions },
+        { "Declarations "sv, handler.getDeclCount(),        &UnitCounts::declarations },
+        { "Expressions  "sv, handler.getExprCount(),        &UnitCounts::expressions },
+        { "Comments     "sv, handler.getCommentCount(),     &UnitCounts::comments },
+        { "Returns      "sv, handler.getReturnCount(),      &UnitCounts::returns },
+        { "Line Comments"sv, handler.getLineCommentCount(), &UnitCounts::lineComments },
+        { "Strings      "sv, handler.getLiteralCount(),     &UnitCounts::strings },
+    };
+
+    // output Report
+    out << "# srcFacts: " << title << '\n';
+    out << "| Measure       | " << std::setw(valueWidth + 2) << "Value |";
+    for (const auto& column : languageColumns)
+        out << ' ' << std::setw(column.width + 2) << column.name + " |";
+    out << '\n';
+    out << "|:--------------|-" << std::setw(valueWidth + 2) << std::setfill('-') << ":|";
+    for (const auto& column : languageColumns)
+        out << '-' << std::setw(column.width + 2) << ":|";
+    out << '\n' << std::setfill(' ');
+    for (const auto& row : rows) {
+        out << "| " << row.measure << " | " << std::setw(valueWidth) << row.value << " |";
+        for (const auto& column : languageColumns)
+            out << ' ' << std::setw(column.width) << (row.languageMeasure ? column.counts.*row.languageMeasure : column.files) << " |";
+        out << '\n';
+    }
+}
@@ -0,0 +1,26 @@
+/*
+    srcFactsReport.hpp
+
+    Include file for the markdown report of the srcFacts measures
+*/
+
+#ifndef INCLUDED_SRCFACTSREPORT_HPP
+#define INCLUDED_SRCFACTSREPORT_HPP
+
+#include <ostream>
+#include <string_view>
+
+#include "srcFactsParser.hpp"
+
+/*
+    Output the measures as a markdown table, with a column for each language
+
+    @param out Stream for the report, imbued with the locale of the numbers
+    @param handler Handler with the counts of the document
+    @param totalBytes Size of the document, for the width of the values
+    @param title Title of the report, e.g., the URL of the archive
+    @param files Number of source files, e.g., the units of an archive without the root unit
+*/
+void srcFactsReport(std::ostream& out, srcFactsParser& handler, long long totalBytes, std::string_view title, long long files);
+
+#endif
@@ -0,0 +1,336 @@
+/*
+    srcFactsServer.cpp
+
+    Implementation file for the srcFacts server on a Unix domain socket
+*/
+
+#include "srcFactsServer.hpp"
+
+#include <iostream>
+
+#if !defined(_MSC_VER)
+
+#include "srcFactsParser.hpp"
+#include "srcFactsReport.hpp"
+#include "MemoryInputSource.hpp"
+#include "DecompressInputSource.hpp"
+
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <locale>
+#include <charconv>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <exception>
+#include <utility>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // size of each read from the client
+    constexpr std::size_t READ_SIZE = 64 * 1024;
+
+    // maximum length of a command line
+    constexpr std::size_t MAX_COMMAND = 4096;
+
+    // maximum length of the document of a DATA request, as it is held in memory
+    constexpr std::size_t MAX_DATA = std::size_t(1) << 30;
+
+    // buffered reads and unbuffered replies of a client connection
+    class Connection {
+
+        public:
+
+        explicit Connection(int fd) : fd(fd), buffer(READ_SIZE) {}
+
+        Connection(const Connection&) = delete;
+
+        Connection& operator=(const Connection&) = delete;
+
+        ~Connection() {
+
+            close(fd);
+        }
+
+        // next line without the newline, false at the end of the input or for a line too long
+        [[nodiscard]] bool readLine(std::string& line) {
+
+            std::size_t searched = begin;
+            while (true) {
+                const auto newline = std::find(buffer.data() + searched, buffer.data() + end, '\n');
+                if (newline != buffer.data() + end) {
+                    line.assign(buffer.data() + begin, newline);
+                    begin = static_cast<std::size_t>(newline - buffer.data()) + 1;
+                    return true;
+                }
+                if (end - begin >= MAX_COMMAND)
+                    return false;
+
+                // partial line is moved to the start of the buffer before more is read
+                searched = end - begin;
+                std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+                end -= begin;
+                begin = 0;
+                const long bytesRead = readSome(buffer.data() + end, buffer.size() - end);
+                if (bytesRead <= 0)
+                    return false;
+                end += static_cast<std::size_t>(bytesRead);
+            }
+        }
+
+        // bytes of the size, read first from the buffer, false at the end of the input
+        [[nodiscard]] bool readBytes(std::size_t size, std::string& data) {
+
+            const std::size_t buffered = std::min(size, end - begin);
+            data.resize(size);
+            std::memcpy(data.data(), buffer.data() + begin, buffered);
+            begin += buffered;
+            for (std::size_t total = buffered; total < size; ) {
+                const long bytesRead = readSome(data.data() + total, size - total);
+                if (bytesRead <= 0)
+                    return false;
+                total += static_cast<std::size_t>(bytesRead);
+            }
+
+            return true;
+        }
+
+        // reply of a status line with the length of the body, then the body, in one write when possible
+        [[nodiscard]] bool reply(std::string_view status, std::string_view body) {
+
+            std::string header(status);
+            header += ' ';
+            header += std::to_string(body.size());
+            header += '\n';
+            iovec iov[2] = { { header.data(), header.size() }, { const_cast<char*>(body.data()), body.size() } };
+            int count = 2;
+            iovec* pieces = iov;
+            while (count > 0) {
+                const ssize_t bytesWritten = writev(fd, pieces, count);
+                if (bytesWritten == -1) {
+                    if (errno == EINTR)
+                        continue;
+                    return false;
+                }
+
+                // skip the written part of the pieces
+                std::size_t written = static_cast<std::size_t>(bytesWritten);
+                while (count > 0 && written >= pieces[0].iov_len) {
+                    written -= pieces[0].iov_len;
+                    ++pieces;
+                    --count;
+                }
+                if (count > 0) {
+                    pieces[0].iov_base = static_cast<char*>(pieces[0].iov_base) + written;
+                    pieces[0].iov_len -= written;
+                }
+            }
+
+            return true;
+        }
+
+        private:
+
+        // read into the data, continuing after interrupts
+        [[nodiscard]] long readSome(char* data, std::size_t size) {
+
+            ssize_t bytesRead = 0;
+            do {
+                bytesRead = read(fd, data, size);
+            } while (bytesRead == -1 && errno == EINTR);
+
+            return static_cast<long>(bytesRead);
+        }
+
+        int fd;
+        std::vector<char> buffer;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+
+    // parse the document of the input, with the message of the parse error, empty if none
+    [[nodiscard]] std::string parseDocument(srcFactsParser& handler, InputSource& input, Tokenizer tokenizer, long long& totalBytes) {
+
+        BasicXMLParser<srcFactsParser> parser(handler, input, tokenizer);
+        XMLParseError error = parser.parse();
+        totalBytes = parser.getTotalBytes();
+        return std::move(error.message);
+    }
+
+    // reply to one request, false when the connection cannot continue
+    [[nodiscard]] bool serveRequest(Connection& connection, const std::string& command, srcFactsParser& handler, Tokenizer tokenizer, std::ostringstream& report, std::string& document) {
+
+        handler.reset();
+        std::string error;
+        long long totalBytes = 0;
+        if (command.compare(0, 5, "PATH "sv) == 0) {
+            const std::string path = command.substr(5);
+            auto input = makeInputSource(path.c_str());
+            if (input)
+                error = parseDocument(handler, *input, tokenizer, totalBytes);
+            else
+                error = "srcfacts error : Unable to open file '" + path + "'";
+        } else if (command.compare(0, 5, "DATA "sv) == 0) {
+
+            // the next request cannot be found without the length
+            std::size_t length = 0;
+            const auto result = std::from_chars(command.data() + 5, command.data() + command.size(), length);
+            if (result.ec != std::errc() || result.ptr != command.data() + command.size()) {
+                (void) connection.reply("ERROR"sv, "srcfacts error : Invalid length '" + command.substr(5) + "'");
+                return false;
+            }
+            if (length > MAX_DATA) {
+                (void) connection.reply("ERROR"sv, "srcfacts error : Length " + command.substr(5) + " over the maximum of " + std::to_string(MAX_DATA) + ", use PATH");
+                return false;
+            }
+            if (!connection.readBytes(length, document)) {
+                (void) connection.reply("ERROR"sv, "srcfacts error : Document ended before length " + command.substr(5));
+                return false;
+            }
+
+            // uncompressed data is parsed in place
+            if (detectCompression(document) == Compression::NONE) {
+                MemoryInputSource input(document);
+                error = parseDocument(handler, input, tokenizer, totalBytes);
+            } else {
+                DecompressInputSource input(std::make_unique<MemoryInputSource>(document));
+                error = parseDocument(handler, input, tokenizer, totalBytes);
+            }
+        } else {
+            error = "srcfacts error : Unknown request '" + command + "'";
+        }
+
+        if (!error.empty())
+            return connection.reply("ERROR"sv, error);
+
+        report.str(std::string());
+        srcFactsReport(report, handler, totalBytes, handler.getURL(), std::max(handler.getUnitCount() - 1, 1LL));
+        return connection.reply("OK"sv, report.str());
+    }
+
+    // serve the requests of a connection until the client closes it, or a request cannot be read
+    void serveConnection(int fd, srcFactsParser& handler, Tokenizer tokenizer, std::ostringstream& report, std::string& document) {
+
+        Connection connection(fd);
+        std::string command;
+        while (connection.readLine(command)) {
+
+            // an exception ends the connection with an error reply, not the worker
+            try {
+                if (!serveRequest(connection, command, handler, tokenizer, report, document))
+                    return;
+            } catch (const std::exception& exception) {
+                (void) connection.reply("ERROR"sv, std::string("srcfacts error : ") + exception.what());
+                return;
+            }
+        }
+    }
+}
+
+/*
+    Serve srcFacts requests on a Unix domain socket until the process is stopped.
+    A socket file left by a stopped server is replaced.
+
+    @param socketPath Path of the socket file
+    @param jobs Number of worker threads
+    @param tokenizer Tokenizer of the parsers
+    @return Status of the server, 1 when the socket cannot be created
+*/
+[[nodiscard]] int srcFactsServer(const char* socketPath, int jobs, Tokenizer tokenizer) {
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (std::strlen(socketPath) >= sizeof(address.sun_path)) {
+        std::cerr << "srcfacts error : Socket path too long '" << socketPath << "'\n";
+        return 1;
+    }
+    std::strcpy(address.sun_path, socketPath);
+
+    // a socket file that accepts a connection is of a running server, otherwise it is left by a stopped server
+    const int probeFD = socket(AF_UNIX, SOCK_STREAM, 0);
+    const bool inUse = probeFD != -1 && connect(probeFD, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    if (probeFD != -1)
+        close(probeFD);
+    if (inUse) {
+        std::cerr << "srcfacts error : Socket in use '" << socketPath << "'\n";
+        return 1;
+    }
+    unlink(socketPath);
+
+    const int listenFD = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFD == -1 || bind(listenFD, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 || listen(listenFD, SOMAXCONN) == -1) {
+        std::cerr << "srcfacts error : Unable to create socket '" << socketPath << "'\n";
+        return 1;
+    }
+
+    // a client that closes before its reply ends the connection, not the server
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // locale of the numbers, created once for all the reports
+    const std::locale locale{""};
+
+    // each worker accepts connections, with its handler and buffers reused for all requests
+    std::atomic<bool> acceptError = false;
+    auto worker = [&]() {
+        srcFactsParser handler;
+        std::ostringstream report;
+        report.imbue(locale);
+        std::string document;
+        while (true) {
+            const int fd = accept(listenFD, nullptr, nullptr);
+            if (fd == -1) {
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+                acceptError = true;
+                return;
+            }
+            serveConnection(fd, handler, tokenizer, report, document);
+        }
+    };
+    std::clog << "srcfacts server : " << socketPath << ", " << jobs << " jobs\n";
+    std::vector<std::thread> workers;
+    workers.reserve(jobs);
+    for (int i = 0; i < jobs; ++i)
+        workers.emplace_back(worker);
+    for (auto& thread : workers)
+        thread.join();
+
+    close(listenFD);
+    unlink(socketPath);
+    if (acceptError)
+        std::cerr << "srcfacts error : Unable to accept connections on '" << socketPath << "'\n";
+
+    return acceptError ? 1 : 0;
+}
+
+#else
+
+/*
+    Serve srcFacts requests on a Unix domain socket until the process is stopped.
+    A socket file left by a stopped server is replaced.
+
+    @param socketPath Path of the socket file
+    @param jobs Number of worker threads
+    @param tokenizer Tokenizer of the parsers
+    @return Status of the server, 1 when the socket cannot be created
+*/
+[[nodiscard]] int srcFactsServer(const char* socketPath, int jobs, Tokenizer tokenizer) {
+
+    std::cerr << "srcfacts error : Server requires Unix domain sockets\n";
+    return 1;
+}
+
+#endif
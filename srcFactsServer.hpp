@@ -0,0 +1,43 @@
+/*
+    srcFactsServer.hpp
+
+    Include file for the srcFacts server on a Unix domain socket.
+
+    A client connects to the socket and sends requests, each a command line,
+    with the document after the line for DATA:
+
+        PATH <path>\n               srcML file on the server, compressed or not
+        DATA <length>\n<document>   srcML document of length bytes, at most 1 GiB
+
+    Each request has a reply, a status line with the length of the body,
+    then the body:
+
+        OK <length>\n<report>       markdown report of srcfacts
+        ERROR <length>\n<message>   message of the parse or input error
+
+    The connection stays open for further requests until the client closes it.
+    Each worker thread of the pool accepts a connection and serves its
+    requests with its own srcFactsParser, reused for each request, so
+    separate connections are parsed in parallel. An error ends the request,
+    not the server. A DATA request that is too long, or whose document ends
+    early, has an ERROR reply, and then the connection is closed, as the start
+    of the next request is unknown. Larger documents are sent with PATH.
+*/
+
+#ifndef INCLUDED_SRCFACTSSERVER_HPP
+#define INCLUDED_SRCFACTSSERVER_HPP
+
+#include "XMLParser.hpp"
+
+/*
+    Serve srcFacts requests on a Unix domain socket until the process is stopped.
+    A socket file left by a stopped server is replaced.
+
+    @param socketPath Path of the socket file
+    @param jobs Number of worker threads
+    @param tokenizer Tokenizer of the parsers
+    @return Status of the server, 1 when the socket cannot be created
+*/
+[[nodiscard]] int srcFactsServer(const char* socketPath, int jobs, Tokenizer tokenizer = Tokenizer::SCAN);
+
+#endif
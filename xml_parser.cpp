@@ -22,6 +22,11 @@ const std::bitset<128> xmlNameMask("00000111111111111111111111111110100001111111
 constexpr auto WHITESPACE = " \n\t\r"sv;
 constexpr auto NAMEEND = "> /\":=\n\t\r"sv;
 
+const int BUFFER_SIZE = 16 * 16 * 4096;
+
+// buffer for the content read from standard input
+static char buffer[BUFFER_SIZE];
+
 // trace parsing
 #ifdef TRACE
 #undef TRACE
@@ -46,7 +51,7 @@ void xml_parser::startTracing() {
 // check for file input
 void xml_parser::checkFIleInput(std::string_view& text, long& totalBytes) {
 
-    int bytesRead = refillContent(text);
+    long bytesRead = refillContent(0, buffer, BUFFER_SIZE, text);
     if (bytesRead < 0) {
         std::cerr << "parser error : File input error\n";
         exit(1);
@@ -235,7 +240,7 @@ void xml_parser::parseDOCTYPE(std::string_view& text) {
 // refill content preserving unprocessed
 void xml_parser::refillContentUnprocessed(std::string_view& text, bool& doneReading, long& totalBytes) {
        
-    int bytesRead = refillContent(text);
+    long bytesRead = refillContent(0, buffer, BUFFER_SIZE, text);
     if (bytesRead < 0) {
         std::cerr << "parser error : File input error\n";
         exit(1);
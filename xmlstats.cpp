@@ -3,41 +3,138 @@
 
     Markdown report with the number of each part of XML.
     e.g., the number of start tags, end tags, attributes, character sections, etc.
+
+    Reads standard input, or the files and glob patterns of the command line,
+    parsed in parallel, with a report for each file and for all the files.
 */
 
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cstdlib>
 
+#include "InputSource.hpp"
 #include "XMLParser.hpp"
 #include "XMLStatsParser.hpp"
+#include "inputFiles.hpp"
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // counts of an input file
+    struct FileStats {
+        std::string path;
+        XMLStatsParser handler;
+        long long totalBytes = 0;
+        XMLParseError error;
+    };
+
+    // markdown report of the counts, with the title after the heading
+    void outputReport(XMLStatsParser& handler, long long totalBytes, std::string_view title) {
+
+        int valueWidth = std::max(5, static_cast<int>(log10(std::max(totalBytes, 1LL)) * 1.3 + 1));
+
+        // output xmlstats
+        std::cout << "# XMLStates: " << title << '\n';
+        std::cout << "| Measure                | " << std::setw(valueWidth + 3) << "Value |\n";
+        std::cout << "|:-----------------------|-" << std::setw(valueWidth + 3) << std::setfill('-')             << ":|\n" << std::setfill(' ');
+        std::cout << "| Start Document         | " << std::setw(valueWidth) << handler.getStartDocCount()         << " |\n";
+        std::cout << "| XML Declaration        | " << std::setw(valueWidth) << handler.getXMLDeclarationCount()   << " |\n";
+        std::cout << "| DOCTYPE                | " << std::setw(valueWidth) << handler.getDOCTYPECount()          << " |\n";
+        std::cout << "| Start Tags             | " << std::setw(valueWidth) << handler.getStartTagCount()         << " |\n";
+        std::cout << "| End Tags               | " << std::setw(valueWidth) << handler.getEndTagCount()           << " |\n";
+        std::cout << "| Attributes             | " << std::setw(valueWidth) << handler.getAttributeCount()        << " |\n";
+        std::cout << "| XML Namespace          | " << std::setw(valueWidth) << handler.getNamespaceCount()        << " |\n";
+        std::cout << "| XML Comments           | " << std::setw(valueWidth) << handler.getCommentCount()          << " |\n";
+        std::cout << "| CDATA                  | " << std::setw(valueWidth) << handler.getCDATACount()            << " |\n";
+        std::cout << "| Processing Instruction | " << std::setw(valueWidth) << handler.getPICount()               << " |\n";
+        std::cout << "| CER                    | " << std::setw(valueWidth) << handler.getCERCount()              << " |\n";
+        std::cout << "| nonCER                 | " << std::setw(valueWidth) << handler.getNonCERCount()           << " |\n";
+        std::cout << "| End Document           | " << std::setw(valueWidth) << handler.getEndDocCount()           << " |\n";
+        std::cout << "\n";
+    }
+}
 
 int main(int argc, char* argv[]) {
 
+    // number of worker threads for the input files, with 0 for all cores
+    int jobs = 1;
+    // input files and glob patterns, with standard input if none
+    std::vector<std::string_view> inputArguments;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if ((arg == "-j"sv || arg == "--jobs"sv) && i + 1 < argc) {
+            jobs = atoi(argv[++i]);
+        } else if (!arg.empty() && arg[0] != '-') {
+            inputArguments.push_back(arg);
+        } else {
+            std::cerr << "usage: xmlstats [-j jobs] [file.xml ...] < file.xml\n";
+            return 1;
+        }
+    }
+    if (jobs < 1)
+        jobs = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    if (inputArguments.empty()) {
+        XMLStatsParser handler;
+        auto input = makeInputSource();
+        BasicXMLParser<XMLStatsParser> parser(handler, *input);
+
+        if (const auto error = parser.parse()) {
+            std::cerr << error.message << '\n';
+            return 1;
+        }
+
+        outputReport(handler, parser.getTotalBytes(), ""sv);
+        return 0;
+    }
+
+    std::vector<std::string> paths;
+    std::string unmatched;
+    if (!expandInputFiles(inputArguments, paths, unmatched)) {
+        std::cerr << "xmlstats error : No files match '" << unmatched << "'\n";
+        return 1;
+    }
+
+    // each file is parsed by one worker with its own parser
+    std::vector<FileStats> files(paths.size());
+    parallelFor(files.size(), jobs, [&](std::size_t i) {
+        FileStats& file = files[i];
+        file.path = paths[i];
+        auto input = makeInputSource(file.path.c_str());
+        if (!input) {
+            file.error.code = XMLErrorCode::INPUT;
+            file.error.message = "xmlstats error : Unable to open file";
+            return;
+        }
+        BasicXMLParser<XMLStatsParser> parser(file.handler, *input);
+        file.error = parser.parse();
+        file.totalBytes = parser.getTotalBytes();
+    });
+
+    // report of each file, then of all the files without an error
     XMLStatsParser handler;
-    XMLParser parser(handler);
-
-    parser.parse();
-
-    int valueWidth = std::max(5, static_cast<int>(log10(parser.getTotalBytes()) * 1.3 + 1));
-
-    // output xmlstats
-    std::cout << "# XMLStates: " << '\n';
-    std::cout << "| Measure                | " << std::setw(valueWidth + 3) << "Value |\n";
-    std::cout << "|:-----------------------|-" << std::setw(valueWidth + 3) << std::setfill('-')             << ":|\n" << std::setfill(' ');
-    std::cout << "| Start Document         | " << std::setw(valueWidth) << handler.getStartDocCount()         << " |\n";
-    std::cout << "| XML Declaration        | " << std::setw(valueWidth) << handler.getXMLDeclarationCount()   << " |\n";
-    std::cout << "| DOCTYPE                | " << std::setw(valueWidth) << handler.getDOCTYPECount()          << " |\n";
-    std::cout << "| Start Tags             | " << std::setw(valueWidth) << handler.getStartTagCount()         << " |\n";
-    std::cout << "| End Tags               | " << std::setw(valueWidth) << handler.getEndTagCount()           << " |\n";
-    std::cout << "| Attributes             | " << std::setw(valueWidth) << handler.getAttributeCount()        << " |\n";
-    std::cout << "| XML Namespace          | " << std::setw(valueWidth) << handler.getNamespaceCount()        << " |\n";
-    std::cout << "| XML Comments           | " << std::setw(valueWidth) << handler.getCommentCount()          << " |\n";
-    std::cout << "| CDATA                  | " << std::setw(valueWidth) << handler.getCDATACount()            << " |\n";
-    std::cout << "| Processing Instruction | " << std::setw(valueWidth) << handler.getPICount()               << " |\n";
-    std::cout << "| CER                    | " << std::setw(valueWidth) << handler.getCERCount()              << " |\n";
-    std::cout << "| nonCER                 | " << std::setw(valueWidth) << handler.getNonCERCount()           << " |\n";
-    std::cout << "| End Document           | " << std::setw(valueWidth) << handler.getEndDocCount()           << " |\n";
-    std::cout << "\n";
-    return 0;
+    long long totalBytes = 0;
+    int failedFiles = 0;
+    for (auto& file : files) {
+        if (file.error) {
+            std::cerr << file.path << ": " << file.error.message << '\n';
+            ++failedFiles;
+            continue;
+        }
+        outputReport(file.handler, file.totalBytes, file.path);
+        handler.merge(file.handler);
+        totalBytes += file.totalBytes;
+    }
+    if (files.size() > 1)
+        outputReport(handler, totalBytes, std::to_string(files.size() - failedFiles) + " files");
+
+    return failedFiles ? 1 : 0;
 }